@@ -0,0 +1,117 @@
+#!/usr/bin/python3
+import sys
+import argparse
+import os
+import marshal
+import struct
+import importlib.util
+
+
+HEADER = struct.Struct('<4sIIIIIQQ')
+ENTRY = struct.Struct('<QQIIII')
+VERSION = 1
+PACKAGE_FLAG = 1
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def collect_modules(root, includes):
+    modules = {}
+    for include in includes or ['']:
+        top = os.path.join(root, include)
+        for dirpath, dirnames, filenames in os.walk(top):
+            dirnames[:] = sorted(d for d in dirnames if d != '__pycache__')
+            for filename in sorted(filenames):
+                if not filename.endswith('.py'):
+                    continue
+                path = os.path.join(dirpath, filename)
+                rel = os.path.relpath(path, root)[:-3].replace(os.sep, '.')
+                package = rel == '__init__' or rel.endswith('.__init__')
+                if package:
+                    rel = rel[:-9]
+                if rel:
+                    modules[rel] = (path, package)
+    # Directories without __init__.py are packed as empty packages, they may not exist next to the archive
+    for name in list(modules):
+        parts = name.split('.')
+        for i in range(1, len(parts)):
+            modules.setdefault('.'.join(parts[:i]), (None, True))
+    return modules
+
+
+def build(output, root, includes, optimize):
+    archive_name = os.path.basename(output)
+    entries = []
+    for name, (path, package) in sorted(collect_modules(root, includes).items()):
+        if path is None:
+            source = b''
+            filename = f'{archive_name}/{name.replace(".", "/")}/__init__.py'
+        else:
+            with open(path, 'rb') as file:
+                source = file.read()
+            # Tracebacks point into archive, same as origin reported by the importer
+            filename = f'{archive_name}/{os.path.relpath(path, root).replace(os.sep, "/")}'
+        try:
+            code = compile(source, filename, 'exec', dont_inherit=True, optimize=optimize)
+        except SyntaxError as e:
+            print(f'Skip {path}: {e}')
+            continue
+        entries.append((name.encode('utf-8'), marshal.dumps(code), package))
+
+    slot_count = 1
+    while slot_count < len(entries) * 2 or slot_count <= len(entries):
+        slot_count *= 2
+
+    entries_offset = HEADER.size
+    slots_offset = entries_offset + ENTRY.size * len(entries)
+    data_offset = slots_offset + 4 * slot_count
+
+    slots = [0] * slot_count
+    table = bytearray()
+    blobs = bytearray()
+    for index, (name, code, package) in enumerate(entries):
+        h = fnv1a(name)
+        slot = h & (slot_count - 1)
+        while slots[slot]:
+            slot = (slot + 1) & (slot_count - 1)
+        slots[slot] = index + 1
+
+        name_offset = data_offset + len(blobs)
+        blobs += name
+        code_offset = data_offset + len(blobs)
+        blobs += code
+        table += ENTRY.pack(name_offset, code_offset, len(name), len(code), h, PACKAGE_FLAG if package else 0)
+
+    magic = int.from_bytes(importlib.util.MAGIC_NUMBER, 'little')
+    with open(output, 'wb') as file:
+        file.write(HEADER.pack(b'PYAR', VERSION, magic, len(entries), slot_count, 0, entries_offset, slots_offset))
+        file.write(table)
+        file.write(struct.pack(f'<{slot_count}I', *slots))
+        file.write(blobs)
+
+    print(f'Written {len(entries)} modules to {output}')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build memory mapped module archive for the Python 3.12 language module.')
+    parser.add_argument('output', help='Path of archive file to write (.pyar)')
+    parser.add_argument('root', help='Directory module names are relative to')
+    parser.add_argument('include', nargs='*', help='Subdirectories of root to pack, whole root by default')
+    parser.add_argument('--optimize', type=int, default=-1, help='Optimization level passed to compile()')
+    args = parser.parse_args()
+
+    if sys.version_info[:2] != (3, 12):
+        print('Archive should be built with Python 3.12, bytecode is version specific')
+        return 1
+
+    build(args.output, args.root, args.include, args.optimize)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
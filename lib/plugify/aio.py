@@ -0,0 +1,168 @@
+import asyncio
+import sys
+import time
+
+from plugify import _aio
+
+# Maximum time in seconds spent running ready callbacks per host update
+time_slice = 0.002
+
+# Maximum time in seconds cancelled tasks of an ending plugin get to finish their cleanup
+end_timeout = 0.1
+
+_loop = None
+
+if sys.platform == 'win32':
+    _BaseEventLoop = asyncio.ProactorEventLoop
+else:
+    _BaseEventLoop = asyncio.SelectorEventLoop
+
+
+class _HostEventLoop(_BaseEventLoop):
+    """
+    Event loop which records whether callbacks were scheduled, so step() knows if another iteration has work to do.
+    Any new work wakes the host update, which skips idle loops without taking the GIL.
+    """
+
+    def __init__(self):
+        super().__init__()
+        self.scheduled = False
+
+    def call_soon(self, callback, *args, context=None):
+        self.scheduled = True
+        return super().call_soon(callback, *args, context=context)
+
+    def _call_soon(self, callback, args, context):
+        # Also reached by call_soon_threadsafe
+        _aio.wake()
+        return super()._call_soon(callback, args, context)
+
+    def call_at(self, when, callback, *args, context=None):
+        _aio.wake()
+        return super().call_at(when, callback, *args, context=context)
+
+    def _add_reader(self, fd, callback, *args):
+        _aio.wake()
+        return super()._add_reader(fd, callback, *args)
+
+    def _add_writer(self, fd, callback, *args):
+        _aio.wake()
+        return super()._add_writer(fd, callback, *args)
+
+    def has_work(self):
+        """
+        Whether the next host update has to step the loop: ready or timed callbacks, or sockets to poll.
+        """
+        if self._ready or self._scheduled:
+            return True
+        selector = getattr(self, '_selector', None)
+        # Proactor completions can only be polled, selector always holds the self-pipe
+        return selector is None or len(selector.get_map()) > 1
+
+
+def get_event_loop():
+    """
+    Return the event loop driven by the host update, create it on first use.
+    """
+    global _loop
+    if _loop is None or _loop.is_closed():
+        _loop = _HostEventLoop()
+        asyncio.set_event_loop(_loop)
+    return _loop
+
+
+def create_task(coro):
+    """
+    Schedule a coroutine on the event loop driven by the host update.
+    """
+    return get_event_loop().create_task(coro)
+
+
+def step():
+    """
+    Run ready callbacks of the event loop without blocking, called by the language module on host updates.
+    Returns whether the loop still has work, an idle loop is not stepped until something wakes it.
+    """
+    loop = _loop
+    if loop is None or loop.is_closed():
+        return False
+    deadline = time.perf_counter() + time_slice
+    while True:
+        loop.call_soon(loop.stop)
+        loop.scheduled = False
+        loop.run_forever()
+        # Callbacks scheduled during this iteration run on the next one while the slice allows
+        if not loop.scheduled or time.perf_counter() >= deadline:
+            break
+    return loop.has_work()
+
+
+def cancel_plugin(plugin):
+    """
+    Cancel tasks and timed callbacks started by code of a plugin, called by the language module when the plugin ends.
+    Tasks inherit the plugin context of code which created them, so they are matched by _aio.current_plugin.
+    """
+    loop = _loop
+    if loop is None or loop.is_closed():
+        return
+    tasks = [task for task in asyncio.all_tasks(loop) if task.get_context().get(_aio.current_plugin) == plugin]
+    for task in tasks:
+        task.cancel()
+    for handle in loop._scheduled:
+        context = handle._context
+        if context is not None and context.get(_aio.current_plugin) == plugin:
+            handle.cancel()
+    # Cleanup of cancelled tasks runs while the plugin is still loaded
+    if tasks and not loop.is_running():
+        loop.run_until_complete(asyncio.wait(tasks, timeout=end_timeout))
+
+
+def close():
+    """
+    Cancel pending tasks and close the event loop, called by the language module on shutdown.
+    """
+    global _loop
+    loop = _loop
+    _loop = None
+    if loop is None or loop.is_closed():
+        return
+    try:
+        tasks = asyncio.all_tasks(loop)
+        for task in tasks:
+            task.cancel()
+        if tasks:
+            loop.run_until_complete(asyncio.gather(*tasks, return_exceptions=True))
+        loop.run_until_complete(loop.shutdown_asyncgens())
+    finally:
+        asyncio.set_event_loop(None)
+        loop.close()
+
+
+class NativeEvent:
+    """
+    Callable which can be passed to native code as a callback and awaited by coroutines.
+
+    Each call resolves all pending waiters with the callback arguments
+    (single argument is passed as is, several as a tuple).
+    """
+
+    def __init__(self):
+        self._waiters = []
+
+    def __call__(self, *args):
+        value = args[0] if len(args) == 1 else args
+        waiters = self._waiters
+        self._waiters = []
+        for future in waiters:
+            # Native code may invoke callbacks from another thread
+            future.get_loop().call_soon_threadsafe(_set_result, future, value)
+
+    def wait(self):
+        future = get_event_loop().create_future()
+        self._waiters.append(future)
+        return future
+
+
+def _set_result(future, value):
+    if not future.done():
+        future.set_result(value)
@@ -0,0 +1,133 @@
+#include "archive.hpp"
+#include <cstring>
+
+#if PY3LM_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace py3lm {
+	std::unique_ptr<Archive> Archive::Open(const std::filesystem::path& path, uint32_t magic) {
+		std::unique_ptr<Archive> archive(new Archive());
+		archive->_path = path;
+
+#if PY3LM_PLATFORM_WINDOWS
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return nullptr;
+		}
+		archive->_file = file;
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+			return nullptr;
+		}
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			return nullptr;
+		}
+		archive->_mapping = mapping;
+		const void* const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!data) {
+			return nullptr;
+		}
+		archive->_size = static_cast<size_t>(size.QuadPart);
+#else
+		const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			return nullptr;
+		}
+		struct stat st{};
+		if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+			close(fd);
+			return nullptr;
+		}
+		void* const data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		// Mapping keeps file referenced
+		close(fd);
+		if (data == MAP_FAILED) {
+			return nullptr;
+		}
+		archive->_size = static_cast<size_t>(st.st_size);
+#endif
+
+		archive->_data = static_cast<const uint8_t*>(data);
+		if (!archive->Validate(magic)) {
+			return nullptr;
+		}
+		return archive;
+	}
+
+	Archive::~Archive() {
+#if PY3LM_PLATFORM_WINDOWS
+		if (_data) {
+			UnmapViewOfFile(_data);
+		}
+		if (_mapping) {
+			CloseHandle(_mapping);
+		}
+		if (_file) {
+			CloseHandle(_file);
+		}
+#else
+		if (_data) {
+			munmap(const_cast<uint8_t*>(_data), _size);
+		}
+#endif
+	}
+
+	bool Archive::Validate(uint32_t magic) {
+		const auto* const header = reinterpret_cast<const Header*>(_data);
+		if (std::memcmp(header->magic, "PYAR", 4) != 0 || header->version != kVersion || header->pycMagic != magic) {
+			return false;
+		}
+		// Slot count is power of two larger than entry count, so lookup always reaches an empty slot
+		if (header->slotCount == 0 || (header->slotCount & (header->slotCount - 1)) != 0 || header->entryCount >= header->slotCount) {
+			return false;
+		}
+		if (header->entriesOffset > _size || (_size - header->entriesOffset) / sizeof(Entry) < header->entryCount) {
+			return false;
+		}
+		if (header->slotsOffset > _size || (_size - header->slotsOffset) / sizeof(uint32_t) < header->slotCount) {
+			return false;
+		}
+		if (header->entriesOffset % alignof(Entry) != 0 || header->slotsOffset % alignof(uint32_t) != 0) {
+			return false;
+		}
+		const auto* const entries = reinterpret_cast<const Entry*>(_data + header->entriesOffset);
+		for (uint32_t i = 0; i < header->entryCount; ++i) {
+			const Entry& entry = entries[i];
+			if (entry.nameOffset > _size || _size - entry.nameOffset < entry.nameSize
+				|| entry.dataOffset > _size || _size - entry.dataOffset < entry.dataSize) {
+				return false;
+			}
+		}
+		_header = header;
+		_entries = entries;
+		_slots = reinterpret_cast<const uint32_t*>(_data + header->slotsOffset);
+		return true;
+	}
+
+	std::optional<Archive::Module> Archive::Find(std::string_view name) const {
+		const uint32_t hash = Hash(name);
+		const uint32_t mask = _header->slotCount - 1;
+		for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+			const uint32_t index = _slots[slot];
+			if (index == 0 || index > _header->entryCount) {
+				return std::nullopt;
+			}
+			const Entry& entry = _entries[index - 1];
+			if (entry.hash == hash && std::string_view(reinterpret_cast<const char*>(_data + entry.nameOffset), entry.nameSize) == name) {
+				return Module{
+					{ reinterpret_cast<const char*>(_data + entry.dataOffset), entry.dataSize },
+					(entry.flags & kPackageFlag) != 0
+				};
+			}
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace py3lm {
+	// Read-only memory mapped archive of marshalled code objects, written by generator/archive.py.
+	// Layout (little endian):
+	//   Header
+	//   Entry[entryCount] at entriesOffset
+	//   uint32_t[slotCount] at slotsOffset - open addressing table of FNV-1a name hashes, entry index + 1 or 0 if empty
+	//   module names and marshalled code referenced by entries
+	class Archive {
+	public:
+		struct Module {
+			std::string_view code;
+			bool package;
+		};
+
+		static std::unique_ptr<Archive> Open(const std::filesystem::path& path, uint32_t magic);
+
+		Archive(const Archive&) = delete;
+		Archive& operator=(const Archive&) = delete;
+		~Archive();
+
+		std::optional<Module> Find(std::string_view name) const;
+		const std::filesystem::path& GetPath() const { return _path; }
+
+	private:
+		struct Header {
+			char magic[4];
+			uint32_t version;
+			uint32_t pycMagic;
+			uint32_t entryCount;
+			uint32_t slotCount;
+			uint32_t reserved;
+			uint64_t entriesOffset;
+			uint64_t slotsOffset;
+		};
+
+		struct Entry {
+			uint64_t nameOffset;
+			uint64_t dataOffset;
+			uint32_t nameSize;
+			uint32_t dataSize;
+			uint32_t hash;
+			uint32_t flags;
+		};
+
+		static constexpr uint32_t kVersion = 1;
+		static constexpr uint32_t kPackageFlag = 1;
+
+		Archive() = default;
+		bool Validate(uint32_t magic);
+
+		static uint32_t Hash(std::string_view name) {
+			uint32_t hash = 2166136261u;
+			for (const char c : name) {
+				hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+			}
+			return hash;
+		}
+
+		std::filesystem::path _path;
+		const uint8_t* _data{};
+		size_t _size{};
+		const Header* _header{};
+		const Entry* _entries{};
+		const uint32_t* _slots{};
+#if PY3LM_PLATFORM_WINDOWS
+		void* _file{};
+		void* _mapping{};
+#endif
+	};
+}
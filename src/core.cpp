@@ -0,0 +1,1367 @@
+#include "core.hpp"
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+
+namespace py3lm {
+	namespace {
+		constexpr std::array<const char*, 5> VectorNames = { nullptr, nullptr, "Vector2", "Vector3", "Vector4" };
+		constexpr std::array<const char*, 5> VectorSpecNames = { nullptr, nullptr, "plugify._core.Vector2", "plugify._core.Vector3", "plugify._core.Vector4" };
+		constexpr std::array<const char*, 5> VectorInitFormats = { nullptr, nullptr, "|dd:Vector2", "|ddd:Vector3", "|dddd:Vector4" };
+		constexpr std::array<const char*, 4> AxisNames = { "x", "y", "z", "w" };
+
+		// Types are owned by the module, which lives in sys.modules until interpreter finalization
+		std::array<PyTypeObject*, 5> VectorTypes{};
+		PyTypeObject* Matrix4x4Type = nullptr;
+
+		std::string FormatDouble(double value) {
+			char* const buffer = PyOS_double_to_string(value, 'r', 0, Py_DTSF_ADD_DOT_0, nullptr);
+			if (!buffer) {
+				return {};
+			}
+			std::string result(buffer);
+			PyMem_Free(buffer);
+			return result;
+		}
+
+		bool IsScalar(PyObject* object) {
+			return PyLong_Check(object) || PyFloat_Check(object);
+		}
+
+		// Attributes of instances of python subclasses, new reference or nullptr when there are none
+		PyObject* InstanceState(PyObject* self, bool& failed) {
+			failed = false;
+			if (!(Py_TYPE(self)->tp_flags & Py_TPFLAGS_HEAPTYPE) || Py_TYPE(self)->tp_dictoffset == 0) {
+				return nullptr;
+			}
+			PyObject* const dict = PyObject_GetAttrString(self, "__dict__");
+			if (!dict) {
+				failed = !PyErr_ExceptionMatches(PyExc_AttributeError);
+				if (!failed) {
+					PyErr_Clear();
+				}
+				return nullptr;
+			}
+			if (!PyDict_Check(dict) || PyDict_GET_SIZE(dict) == 0) {
+				Py_DECREF(dict);
+				return nullptr;
+			}
+			return dict;
+		}
+
+		// (type, args[, state]) as pickle and copy expect from __reduce__, args reference is stolen
+		PyObject* ReduceWithArgs(PyObject* self, PyObject* args) {
+			if (!args) {
+				return nullptr;
+			}
+			bool failed;
+			PyObject* const state = InstanceState(self, failed);
+			if (failed) {
+				Py_DECREF(args);
+				return nullptr;
+			}
+			PyObject* const type = reinterpret_cast<PyObject*>(Py_TYPE(self));
+			return state ? Py_BuildValue("(ONN)", type, args, state) : Py_BuildValue("(ON)", type, args);
+		}
+
+		//
+		// Vector2, Vector3, Vector4
+		//
+
+		template<size_t N>
+		bool IsVector(PyObject* object) {
+			return PyObject_TypeCheck(object, VectorTypes[N]);
+		}
+
+		template<size_t N>
+		double* VectorData(PyObject* object) {
+			return reinterpret_cast<VectorObject<N>*>(object)->data;
+		}
+
+		template<size_t N>
+		PyObject* CreateVector(const std::array<double, N>& values) {
+			PyTypeObject* const type = VectorTypes[N];
+			PyObject* const object = type->tp_alloc(type, 0);
+			if (!object) {
+				return nullptr;
+			}
+			std::copy(values.begin(), values.end(), VectorData<N>(object));
+			return object;
+		}
+
+		template<size_t N>
+		int VectorInit(PyObject* self, PyObject* args, PyObject* kwargs) {
+			static std::array<char*, N + 1> kwlist = []<size_t... I>(std::index_sequence<I...>) {
+				return std::array<char*, N + 1>{ const_cast<char*>(AxisNames[I])..., nullptr };
+			}(std::make_index_sequence<N>{});
+			std::array<double, N> values{};
+			const int result = [&]<size_t... I>(std::index_sequence<I...>) {
+				return PyArg_ParseTupleAndKeywords(args, kwargs, VectorInitFormats[N], kwlist.data(), &values[I]...);
+			}(std::make_index_sequence<N>{});
+			if (!result) {
+				return -1;
+			}
+			std::copy(values.begin(), values.end(), VectorData<N>(self));
+			return 0;
+		}
+
+		template<size_t N>
+		PyObject* VectorRepr(PyObject* self) {
+			const double* const data = VectorData<N>(self);
+			std::string result = VectorNames[N];
+			result += '(';
+			for (size_t i = 0; i < N; ++i) {
+				if (i != 0) {
+					result += ", ";
+				}
+				result += FormatDouble(data[i]);
+			}
+			result += ')';
+			return PyUnicode_FromStringAndSize(result.data(), static_cast<Py_ssize_t>(result.size()));
+		}
+
+		template<size_t N, typename F>
+		PyObject* VectorBinaryOp(PyObject* a, PyObject* b, const char* operation, F&& func) {
+			if (!IsVector<N>(a)) {
+				Py_RETURN_NOTIMPLEMENTED;
+			}
+			if (!IsVector<N>(b)) {
+				PyErr_Format(PyExc_ValueError, "Can only %s another %s", operation, VectorNames[N]);
+				return nullptr;
+			}
+			const double* const lhs = VectorData<N>(a);
+			const double* const rhs = VectorData<N>(b);
+			std::array<double, N> values{};
+			for (size_t i = 0; i < N; ++i) {
+				values[i] = func(lhs[i], rhs[i]);
+			}
+			return CreateVector<N>(values);
+		}
+
+		template<size_t N>
+		PyObject* VectorScalarOp(PyObject* a, PyObject* b, bool divide) {
+			if (!IsVector<N>(a)) {
+				Py_RETURN_NOTIMPLEMENTED;
+			}
+			if (!IsScalar(b)) {
+				PyErr_SetString(PyExc_ValueError, divide ? "Can only divide by a scalar" : "Can only multiply by a scalar");
+				return nullptr;
+			}
+			const double scalar = PyFloat_AsDouble(b);
+			if (scalar == -1.0 && PyErr_Occurred()) {
+				return nullptr;
+			}
+			if (divide && scalar == 0.0) {
+				PyErr_SetString(PyExc_ZeroDivisionError, "float division by zero");
+				return nullptr;
+			}
+			const double* const data = VectorData<N>(a);
+			std::array<double, N> values{};
+			for (size_t i = 0; i < N; ++i) {
+				values[i] = divide ? data[i] / scalar : data[i] * scalar;
+			}
+			return CreateVector<N>(values);
+		}
+
+		template<size_t N>
+		PyObject* VectorAdd(PyObject* a, PyObject* b) {
+			return VectorBinaryOp<N>(a, b, "add", [](double x, double y) { return x + y; });
+		}
+
+		template<size_t N>
+		PyObject* VectorSubtract(PyObject* a, PyObject* b) {
+			return VectorBinaryOp<N>(a, b, "subtract", [](double x, double y) { return x - y; });
+		}
+
+		template<size_t N>
+		PyObject* VectorMultiply(PyObject* a, PyObject* b) {
+			return VectorScalarOp<N>(a, b, false);
+		}
+
+		template<size_t N>
+		PyObject* VectorTrueDivide(PyObject* a, PyObject* b) {
+			return VectorScalarOp<N>(a, b, true);
+		}
+
+		template<size_t N>
+		PyMemberDef* VectorMembers() {
+			static std::array<PyMemberDef, N + 1> members = [] {
+				std::array<PyMemberDef, N + 1> result{};
+				for (size_t i = 0; i < N; ++i) {
+					result[i] = { AxisNames[i], Py_T_DOUBLE, static_cast<Py_ssize_t>(offsetof(VectorObject<N>, data) + i * sizeof(double)), 0, nullptr };
+				}
+				return result;
+			}();
+			return members.data();
+		}
+
+		template<size_t N>
+		PyObject* VectorReduce(PyObject* self, PyObject*) {
+			const double* const data = VectorData<N>(self);
+			PyObject* const args = PyTuple_New(static_cast<Py_ssize_t>(N));
+			if (!args) {
+				return nullptr;
+			}
+			for (size_t i = 0; i < N; ++i) {
+				PyObject* const value = PyFloat_FromDouble(data[i]);
+				if (!value) {
+					Py_DECREF(args);
+					return nullptr;
+				}
+				PyTuple_SET_ITEM(args, static_cast<Py_ssize_t>(i), value);
+			}
+			return ReduceWithArgs(self, args);
+		}
+
+		// Components are plain doubles, so only attributes of subclass instances differ between shallow and deep copies
+		template<size_t N>
+		PyObject* VectorCopyWith(PyObject* self, PyObject* memo) {
+			PyTypeObject* const type = Py_TYPE(self);
+			PyObject* const copy = type->tp_alloc(type, 0);
+			if (!copy) {
+				return nullptr;
+			}
+			std::copy_n(VectorData<N>(self), N, VectorData<N>(copy));
+			bool failed;
+			PyObject* const state = InstanceState(self, failed);
+			if (failed) {
+				Py_DECREF(copy);
+				return nullptr;
+			}
+			if (!state) {
+				return copy;
+			}
+			PyObject* stateCopy = nullptr;
+			if (memo) {
+				if (PyObject* const copyModule = PyImport_ImportModule("copy")) {
+					stateCopy = PyObject_CallMethod(copyModule, "deepcopy", "OO", state, memo);
+					Py_DECREF(copyModule);
+				}
+			} else {
+				stateCopy = PyDict_Copy(state);
+			}
+			Py_DECREF(state);
+			if (!stateCopy || PyObject_SetAttrString(copy, "__dict__", stateCopy) < 0) {
+				Py_XDECREF(stateCopy);
+				Py_DECREF(copy);
+				return nullptr;
+			}
+			Py_DECREF(stateCopy);
+			return copy;
+		}
+
+		template<size_t N>
+		PyObject* VectorCopy(PyObject* self, PyObject*) {
+			return VectorCopyWith<N>(self, nullptr);
+		}
+
+		template<size_t N>
+		PyObject* VectorDeepCopy(PyObject* self, PyObject* memo) {
+			return VectorCopyWith<N>(self, memo);
+		}
+
+		template<size_t N>
+		PyMethodDef* VectorMethods() {
+			static std::array<PyMethodDef, 4> methods = {{
+				{ "__reduce__", &VectorReduce<N>, METH_NOARGS, nullptr },
+				{ "__copy__", &VectorCopy<N>, METH_NOARGS, nullptr },
+				{ "__deepcopy__", &VectorDeepCopy<N>, METH_O, nullptr },
+				{ nullptr, nullptr, 0, nullptr }
+			}};
+			return methods.data();
+		}
+
+		template<size_t N>
+		PyType_Spec* VectorSpec() {
+			static std::array<PyType_Slot, 10> slots = {{
+				{ Py_tp_new, reinterpret_cast<void*>(&PyType_GenericNew) },
+				{ Py_tp_init, reinterpret_cast<void*>(&VectorInit<N>) },
+				{ Py_tp_repr, reinterpret_cast<void*>(&VectorRepr<N>) },
+				{ Py_tp_members, VectorMembers<N>() },
+				{ Py_tp_methods, VectorMethods<N>() },
+				{ Py_nb_add, reinterpret_cast<void*>(&VectorAdd<N>) },
+				{ Py_nb_subtract, reinterpret_cast<void*>(&VectorSubtract<N>) },
+				{ Py_nb_multiply, reinterpret_cast<void*>(&VectorMultiply<N>) },
+				{ Py_nb_true_divide, reinterpret_cast<void*>(&VectorTrueDivide<N>) },
+				{ 0, nullptr }
+			}};
+			static PyType_Spec spec = {
+				VectorSpecNames[N],
+				static_cast<int>(sizeof(VectorObject<N>)),
+				0,
+				Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+				slots.data()
+			};
+			return &spec;
+		}
+
+		//
+		// Matrix4x4
+		//
+
+		using MatrixValues = std::array<double, 16>;
+
+		constexpr MatrixValues IdentityValues = {
+			1.0, 0.0, 0.0, 0.0,
+			0.0, 1.0, 0.0, 0.0,
+			0.0, 0.0, 1.0, 0.0,
+			0.0, 0.0, 0.0, 1.0
+		};
+
+		bool IsMatrix(PyObject* object) {
+			return PyObject_TypeCheck(object, Matrix4x4Type);
+		}
+
+		PyObject* CreateRows(const MatrixValues& values) {
+			PyObject* const rows = PyList_New(4);
+			if (!rows) {
+				return nullptr;
+			}
+			for (Py_ssize_t i = 0; i < 4; ++i) {
+				PyObject* const row = PyList_New(4);
+				if (!row) {
+					Py_DECREF(rows);
+					return nullptr;
+				}
+				PyList_SET_ITEM(rows, i, row);
+				for (Py_ssize_t j = 0; j < 4; ++j) {
+					PyObject* const value = PyFloat_FromDouble(values[static_cast<size_t>(i * 4 + j)]);
+					if (!value) {
+						Py_DECREF(rows);
+						return nullptr;
+					}
+					PyList_SET_ITEM(row, j, value);
+				}
+			}
+			return rows;
+		}
+
+		PyObject* CreateMatrix(const MatrixValues& values) {
+			PyObject* const rows = CreateRows(values);
+			if (!rows) {
+				return nullptr;
+			}
+			PyObject* const object = Matrix4x4Type->tp_alloc(Matrix4x4Type, 0);
+			if (!object) {
+				Py_DECREF(rows);
+				return nullptr;
+			}
+			reinterpret_cast<Matrix4x4Object*>(object)->m = rows;
+			return object;
+		}
+
+		bool IsRowsList(PyObject* object) {
+			if (!PyList_Check(object) || PyList_GET_SIZE(object) != 4) {
+				return false;
+			}
+			for (Py_ssize_t i = 0; i < 4; ++i) {
+				PyObject* const row = PyList_GET_ITEM(object, i);
+				if (!PyList_Check(row) || PyList_GET_SIZE(row) != 4) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool ReadMatrix(PyObject* object, MatrixValues& values) {
+			PyObject* const rows = reinterpret_cast<Matrix4x4Object*>(object)->m;
+			if (!rows || !IsRowsList(rows)) {
+				PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 list");
+				return false;
+			}
+			for (Py_ssize_t i = 0; i < 4; ++i) {
+				PyObject* const row = PyList_GET_ITEM(rows, i);
+				for (Py_ssize_t j = 0; j < 4; ++j) {
+					const double value = PyFloat_AsDouble(PyList_GET_ITEM(row, j));
+					if (value == -1.0 && PyErr_Occurred()) {
+						return false;
+					}
+					values[static_cast<size_t>(i * 4 + j)] = value;
+				}
+			}
+			return true;
+		}
+
+		int MatrixTraverse(PyObject* self, visitproc visit, void* arg) {
+			Py_VISIT(reinterpret_cast<Matrix4x4Object*>(self)->m);
+			Py_VISIT(Py_TYPE(self));
+			return 0;
+		}
+
+		int MatrixClear(PyObject* self) {
+			Py_CLEAR(reinterpret_cast<Matrix4x4Object*>(self)->m);
+			return 0;
+		}
+
+		void MatrixDealloc(PyObject* self) {
+			PyTypeObject* const type = Py_TYPE(self);
+			PyObject_GC_UnTrack(self);
+			MatrixClear(self);
+			type->tp_free(self);
+			Py_DECREF(type);
+		}
+
+		int MatrixInit(PyObject* self, PyObject* args, PyObject* kwargs) {
+			static std::array kwlist = { const_cast<char*>("m"), static_cast<char*>(nullptr) };
+			PyObject* m = Py_None;
+			if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O:Matrix4x4", kwlist.data(), &m)) {
+				return -1;
+			}
+			PyObject* rows;
+			if (m == Py_None) {
+				rows = CreateRows(IdentityValues);
+				if (!rows) {
+					return -1;
+				}
+			} else if (PyList_Check(m) && PyList_GET_SIZE(m) == 16) {
+				rows = PyList_New(4);
+				if (!rows) {
+					return -1;
+				}
+				for (Py_ssize_t i = 0; i < 4; ++i) {
+					PyObject* const row = PyList_GetSlice(m, i * 4, i * 4 + 4);
+					if (!row) {
+						Py_DECREF(rows);
+						return -1;
+					}
+					PyList_SET_ITEM(rows, i, row);
+				}
+			} else if (IsRowsList(m)) {
+				rows = Py_NewRef(m);
+			} else {
+				PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 or 1x16 list");
+				return -1;
+			}
+			Py_XSETREF(reinterpret_cast<Matrix4x4Object*>(self)->m, rows);
+			return 0;
+		}
+
+		PyObject* MatrixRepr(PyObject* self) {
+			PyObject* const rows = reinterpret_cast<Matrix4x4Object*>(self)->m;
+			if (!rows || !PyList_Check(rows) || PyList_GET_SIZE(rows) != 4) {
+				PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 list");
+				return nullptr;
+			}
+			return PyUnicode_FromFormat("Row 0: %R\nRow 1: %R\nRow 2: %R\nRow 3: %R",
+										PyList_GET_ITEM(rows, 0), PyList_GET_ITEM(rows, 1), PyList_GET_ITEM(rows, 2), PyList_GET_ITEM(rows, 3));
+		}
+
+		template<typename F>
+		PyObject* MatrixElementwiseOp(PyObject* a, PyObject* b, const char* operation, F&& func) {
+			if (!IsMatrix(a)) {
+				Py_RETURN_NOTIMPLEMENTED;
+			}
+			if (!IsMatrix(b)) {
+				PyErr_Format(PyExc_ValueError, "Can only %s another Matrix4x4", operation);
+				return nullptr;
+			}
+			MatrixValues lhs{}, rhs{};
+			if (!ReadMatrix(a, lhs) || !ReadMatrix(b, rhs)) {
+				return nullptr;
+			}
+			MatrixValues values{};
+			for (size_t i = 0; i < values.size(); ++i) {
+				values[i] = func(lhs[i], rhs[i]);
+			}
+			return CreateMatrix(values);
+		}
+
+		PyObject* MatrixAdd(PyObject* a, PyObject* b) {
+			return MatrixElementwiseOp(a, b, "add", [](double x, double y) { return x + y; });
+		}
+
+		PyObject* MatrixSubtract(PyObject* a, PyObject* b) {
+			return MatrixElementwiseOp(a, b, "subtract", [](double x, double y) { return x - y; });
+		}
+
+		PyObject* MatrixMultiply(PyObject* a, PyObject* b) {
+			if (!IsMatrix(a)) {
+				Py_RETURN_NOTIMPLEMENTED;
+			}
+			MatrixValues lhs{};
+			if (IsMatrix(b)) {
+				MatrixValues rhs{};
+				if (!ReadMatrix(a, lhs) || !ReadMatrix(b, rhs)) {
+					return nullptr;
+				}
+				MatrixValues values{};
+				for (size_t i = 0; i < 4; ++i) {
+					for (size_t j = 0; j < 4; ++j) {
+						double sum = 0.0;
+						for (size_t k = 0; k < 4; ++k) {
+							sum += lhs[i * 4 + k] * rhs[k * 4 + j];
+						}
+						values[i * 4 + j] = sum;
+					}
+				}
+				return CreateMatrix(values);
+			}
+			if (!IsScalar(b)) {
+				PyErr_SetString(PyExc_ValueError, "Can only multiply by another Matrix4x4 or a scalar");
+				return nullptr;
+			}
+			const double scalar = PyFloat_AsDouble(b);
+			if ((scalar == -1.0 && PyErr_Occurred()) || !ReadMatrix(a, lhs)) {
+				return nullptr;
+			}
+			for (double& value : lhs) {
+				value *= scalar;
+			}
+			return CreateMatrix(lhs);
+		}
+
+		PyObject* MatrixTrueDivide(PyObject* a, PyObject* b) {
+			if (!IsMatrix(a)) {
+				Py_RETURN_NOTIMPLEMENTED;
+			}
+			if (!IsScalar(b)) {
+				PyErr_SetString(PyExc_ValueError, "Can only divide by a scalar");
+				return nullptr;
+			}
+			const double scalar = PyFloat_AsDouble(b);
+			if (scalar == -1.0 && PyErr_Occurred()) {
+				return nullptr;
+			}
+			if (scalar == 0.0) {
+				PyErr_SetString(PyExc_ZeroDivisionError, "float division by zero");
+				return nullptr;
+			}
+			MatrixValues values{};
+			if (!ReadMatrix(a, values)) {
+				return nullptr;
+			}
+			for (double& value : values) {
+				value /= scalar;
+			}
+			return CreateMatrix(values);
+		}
+
+		PyObject* MatrixTranspose(PyObject* self, PyObject*) {
+			MatrixValues values{};
+			if (!ReadMatrix(self, values)) {
+				return nullptr;
+			}
+			MatrixValues result{};
+			for (size_t i = 0; i < 4; ++i) {
+				for (size_t j = 0; j < 4; ++j) {
+					result[i * 4 + j] = values[j * 4 + i];
+				}
+			}
+			return CreateMatrix(result);
+		}
+
+		PyObject* MatrixIdentity(PyObject*, PyObject*) {
+			return CreateMatrix(IdentityValues);
+		}
+
+		PyObject* MatrixZero(PyObject*, PyObject*) {
+			return CreateMatrix({});
+		}
+
+		PyObject* MatrixFromList(PyObject*, PyObject* m) {
+			return PyObject_CallOneArg(reinterpret_cast<PyObject*>(Matrix4x4Type), m);
+		}
+
+		PyObject* MatrixToList(PyObject* self, PyObject*) {
+			PyObject* const rows = reinterpret_cast<Matrix4x4Object*>(self)->m;
+			if (!rows || !PyList_Check(rows)) {
+				PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 list");
+				return nullptr;
+			}
+			const Py_ssize_t size = PyList_GET_SIZE(rows);
+			PyObject* const result = PyList_New(size);
+			if (!result) {
+				return nullptr;
+			}
+			for (Py_ssize_t i = 0; i < size; ++i) {
+				PyObject* const row = PyList_GET_ITEM(rows, i);
+				PyObject* const copy = PyList_Check(row) ? PyList_GetSlice(row, 0, PY_SSIZE_T_MAX) : PySequence_List(row);
+				if (!copy) {
+					Py_DECREF(result);
+					return nullptr;
+				}
+				PyList_SET_ITEM(result, i, copy);
+			}
+			return result;
+		}
+
+		PyObject* MatrixReduce(PyObject* self, PyObject*) {
+			PyObject* const rows = reinterpret_cast<Matrix4x4Object*>(self)->m;
+			if (!rows) {
+				PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 list");
+				return nullptr;
+			}
+			return ReduceWithArgs(self, PyTuple_Pack(1, rows));
+		}
+
+		std::array<PyMethodDef, 7> MatrixMethods = {{
+			{ "__reduce__", &MatrixReduce, METH_NOARGS, nullptr },
+			{ "transpose", &MatrixTranspose, METH_NOARGS, nullptr },
+			{ "identity", &MatrixIdentity, METH_NOARGS | METH_STATIC, nullptr },
+			{ "zero", &MatrixZero, METH_NOARGS | METH_STATIC, nullptr },
+			{ "from_list", &MatrixFromList, METH_O | METH_STATIC, nullptr },
+			{ "to_list", &MatrixToList, METH_NOARGS, nullptr },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		std::array<PyMemberDef, 2> MatrixMembers = {{
+			{ "m", Py_T_OBJECT_EX, offsetof(Matrix4x4Object, m), 0, nullptr },
+			{ nullptr, 0, 0, 0, nullptr }
+		}};
+
+		std::array<PyType_Slot, 14> MatrixSlots = {{
+			{ Py_tp_new, reinterpret_cast<void*>(&PyType_GenericNew) },
+			{ Py_tp_init, reinterpret_cast<void*>(&MatrixInit) },
+			{ Py_tp_dealloc, reinterpret_cast<void*>(&MatrixDealloc) },
+			{ Py_tp_traverse, reinterpret_cast<void*>(&MatrixTraverse) },
+			{ Py_tp_clear, reinterpret_cast<void*>(&MatrixClear) },
+			{ Py_tp_repr, reinterpret_cast<void*>(&MatrixRepr) },
+			{ Py_tp_methods, MatrixMethods.data() },
+			{ Py_tp_members, MatrixMembers.data() },
+			{ Py_nb_add, reinterpret_cast<void*>(&MatrixAdd) },
+			{ Py_nb_subtract, reinterpret_cast<void*>(&MatrixSubtract) },
+			{ Py_nb_multiply, reinterpret_cast<void*>(&MatrixMultiply) },
+			{ Py_nb_true_divide, reinterpret_cast<void*>(&MatrixTrueDivide) },
+			{ 0, nullptr }
+		}};
+
+		PyType_Spec MatrixSpec = {
+			"plugify._core.Matrix4x4",
+			sizeof(Matrix4x4Object),
+			0,
+			Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+			MatrixSlots.data()
+		};
+
+		//
+		// NativeArray
+		//
+
+		PyTypeObject* NativeArrayType = nullptr;
+
+		NativeArrayObject* AsNativeArray(PyObject* object) {
+			return reinterpret_cast<NativeArrayObject*>(object);
+		}
+
+		PyObject* NativeArrayGetItem(NativeArrayObject* array, Py_ssize_t index) {
+			if (!array->items) {
+				array->items = static_cast<PyObject**>(PyMem_Calloc(static_cast<size_t>(array->size), sizeof(PyObject*)));
+				if (!array->items) {
+					return PyErr_NoMemory();
+				}
+			}
+			PyObject* item = array->items[index];
+			if (!item) {
+				if (!array->data) {
+					PyErr_SetString(PyExc_RuntimeError, "Native array is no longer available, elements can be accessed only during the call");
+					return nullptr;
+				}
+				item = array->ops->item(array->data, index);
+				if (!item) {
+					return nullptr;
+				}
+				array->items[index] = item;
+			}
+			return Py_NewRef(item);
+		}
+
+		int NativeArrayTraverse(PyObject* self, visitproc visit, void* arg) {
+			const NativeArrayObject* const array = AsNativeArray(self);
+			if (array->items) {
+				for (Py_ssize_t i = 0; i < array->size; ++i) {
+					Py_VISIT(array->items[i]);
+				}
+			}
+			Py_VISIT(Py_TYPE(self));
+			return 0;
+		}
+
+		int NativeArrayClear(PyObject* self) {
+			NativeArrayObject* const array = AsNativeArray(self);
+			if (PyObject** const items = std::exchange(array->items, nullptr)) {
+				for (Py_ssize_t i = 0; i < array->size; ++i) {
+					Py_XDECREF(items[i]);
+				}
+				PyMem_Free(items);
+			}
+			return 0;
+		}
+
+		void NativeArrayDealloc(PyObject* self) {
+			PyTypeObject* const type = Py_TYPE(self);
+			PyObject_GC_UnTrack(self);
+			NativeArrayClear(self);
+			NativeArrayObject* const array = AsNativeArray(self);
+			if (array->owned && array->data) {
+				array->ops->destroy(array->data);
+			}
+			type->tp_free(self);
+			Py_DECREF(type);
+		}
+
+		Py_ssize_t NativeArrayLength(PyObject* self) {
+			return AsNativeArray(self)->size;
+		}
+
+		PyObject* NativeArrayItem(PyObject* self, Py_ssize_t index) {
+			NativeArrayObject* const array = AsNativeArray(self);
+			if (index < 0 || index >= array->size) {
+				PyErr_SetString(PyExc_IndexError, "NativeArray index out of range");
+				return nullptr;
+			}
+			return NativeArrayGetItem(array, index);
+		}
+
+		PyObject* NativeArraySlice(NativeArrayObject* array, Py_ssize_t start, Py_ssize_t step, Py_ssize_t length) {
+			PyObject* const result = PyList_New(length);
+			if (!result) {
+				return nullptr;
+			}
+			for (Py_ssize_t i = 0, index = start; i < length; ++i, index += step) {
+				PyObject* const item = NativeArrayGetItem(array, index);
+				if (!item) {
+					Py_DECREF(result);
+					return nullptr;
+				}
+				PyList_SET_ITEM(result, i, item);
+			}
+			return result;
+		}
+
+		PyObject* NativeArraySubscript(PyObject* self, PyObject* key) {
+			NativeArrayObject* const array = AsNativeArray(self);
+			if (PyIndex_Check(key)) {
+				Py_ssize_t index = PyNumber_AsSsize_t(key, PyExc_IndexError);
+				if (index == -1 && PyErr_Occurred()) {
+					return nullptr;
+				}
+				if (index < 0) {
+					index += array->size;
+				}
+				return NativeArrayItem(self, index);
+			}
+			if (PySlice_Check(key)) {
+				Py_ssize_t start, stop, step;
+				if (PySlice_Unpack(key, &start, &stop, &step) < 0) {
+					return nullptr;
+				}
+				const Py_ssize_t length = PySlice_AdjustIndices(array->size, &start, &stop, step);
+				return NativeArraySlice(array, start, step, length);
+			}
+			PyErr_Format(PyExc_TypeError, "NativeArray indices must be integers or slices, not %.200s", Py_TYPE(key)->tp_name);
+			return nullptr;
+		}
+
+		PyObject* NativeArrayToList(PyObject* self, PyObject*) {
+			NativeArrayObject* const array = AsNativeArray(self);
+			return NativeArraySlice(array, 0, 1, array->size);
+		}
+
+		// Borrowed data is replaced by a copy on detach, so only owned data can be exported
+		int NativeArrayGetBuffer(PyObject* self, Py_buffer* view, int flags) {
+			const NativeArrayObject* const array = AsNativeArray(self);
+			const NativeArrayOps* const ops = array->ops;
+			if (!ops->buffer || !array->owned || !array->data) {
+				PyErr_SetString(PyExc_BufferError, "Only arrays of plain values returned from native calls provide a buffer");
+				view->obj = nullptr;
+				return -1;
+			}
+			if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+				PyErr_SetString(PyExc_BufferError, "NativeArray is read only");
+				view->obj = nullptr;
+				return -1;
+			}
+			// Shape and strides of up to 3 dimensions share one allocation released with the view
+			auto* const layout = static_cast<Py_ssize_t*>(PyMem_Malloc(6 * sizeof(Py_ssize_t)));
+			if (!layout) {
+				PyErr_NoMemory();
+				view->obj = nullptr;
+				return -1;
+			}
+			int ndim = 1;
+			layout[0] = array->size;
+			for (const Py_ssize_t dim : ops->shape) {
+				if (dim != 0) {
+					layout[ndim++] = dim;
+				}
+			}
+			Py_ssize_t stride = ops->itemSize;
+			for (int i = ndim - 1; i >= 0; --i) {
+				layout[3 + i] = stride;
+				stride *= layout[i];
+			}
+			view->obj = Py_NewRef(self);
+			view->buf = const_cast<void*>(ops->buffer(array->data));
+			view->len = stride;
+			view->readonly = 1;
+			view->itemsize = ops->itemSize;
+			view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(ops->format) : nullptr;
+			view->ndim = ndim;
+			view->shape = (flags & PyBUF_ND) == PyBUF_ND ? layout : nullptr;
+			view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? layout + 3 : nullptr;
+			view->suboffsets = nullptr;
+			view->internal = layout;
+			++AsNativeArray(self)->exports;
+			return 0;
+		}
+
+		void NativeArrayReleaseBuffer(PyObject* self, Py_buffer* view) {
+			PyMem_Free(view->internal);
+			--AsNativeArray(self)->exports;
+		}
+
+		// Equal to a list, tuple or native array with equal elements in the same order
+		PyObject* NativeArrayRichCompare(PyObject* self, PyObject* other, int op) {
+			if ((op != Py_EQ && op != Py_NE) || !(PyList_Check(other) || PyTuple_Check(other) || Py_IS_TYPE(other, NativeArrayType))) {
+				Py_RETURN_NOTIMPLEMENTED;
+			}
+			// Element comparison may run python code, so other sequence is compared through a snapshot
+			PyObject* const items = PySequence_Tuple(other);
+			if (!items) {
+				return nullptr;
+			}
+			NativeArrayObject* const array = AsNativeArray(self);
+			int equal = PyTuple_GET_SIZE(items) == array->size;
+			for (Py_ssize_t i = 0; equal == 1 && i < array->size; ++i) {
+				PyObject* const item = NativeArrayGetItem(array, i);
+				if (!item) {
+					Py_DECREF(items);
+					return nullptr;
+				}
+				equal = PyObject_RichCompareBool(item, PyTuple_GET_ITEM(items, i), Py_EQ);
+				Py_DECREF(item);
+			}
+			Py_DECREF(items);
+			if (equal < 0) {
+				return nullptr;
+			}
+			return PyBool_FromLong(op == Py_EQ ? equal : !equal);
+		}
+
+		PyObject* NativeArrayRepr(PyObject* self) {
+			return PyUnicode_FromFormat("<NativeArray of %zd items>", AsNativeArray(self)->size);
+		}
+
+		std::array<PyMethodDef, 2> NativeArrayMethods = {{
+			{ "to_list", &NativeArrayToList, METH_NOARGS, "to_list() -> list\n\nConvert all elements into a new list." },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		std::array<PyType_Slot, 13> NativeArraySlots = {{
+			{ Py_tp_dealloc, reinterpret_cast<void*>(&NativeArrayDealloc) },
+			{ Py_tp_traverse, reinterpret_cast<void*>(&NativeArrayTraverse) },
+			{ Py_tp_clear, reinterpret_cast<void*>(&NativeArrayClear) },
+			{ Py_tp_repr, reinterpret_cast<void*>(&NativeArrayRepr) },
+			{ Py_tp_richcompare, reinterpret_cast<void*>(&NativeArrayRichCompare) },
+			{ Py_tp_methods, NativeArrayMethods.data() },
+			{ Py_sq_length, reinterpret_cast<void*>(&NativeArrayLength) },
+			{ Py_sq_item, reinterpret_cast<void*>(&NativeArrayItem) },
+			{ Py_mp_length, reinterpret_cast<void*>(&NativeArrayLength) },
+			{ Py_mp_subscript, reinterpret_cast<void*>(&NativeArraySubscript) },
+			{ Py_bf_getbuffer, reinterpret_cast<void*>(&NativeArrayGetBuffer) },
+			{ Py_bf_releasebuffer, reinterpret_cast<void*>(&NativeArrayReleaseBuffer) },
+			{ 0, nullptr }
+		}};
+
+		PyType_Spec NativeArraySpec = {
+			"plugify._core.NativeArray",
+			sizeof(NativeArrayObject),
+			0,
+			Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_DISALLOW_INSTANTIATION | Py_TPFLAGS_SEQUENCE,
+			NativeArraySlots.data()
+		};
+
+		//
+		// Ref
+		//
+
+		PyTypeObject* NativeRefType = nullptr;
+
+		NativeRefObject* AsNativeRef(PyObject* object) {
+			return reinterpret_cast<NativeRefObject*>(object);
+		}
+
+		bool CheckRefData(const NativeRefObject* ref) {
+			if (!ref->data) {
+				PyErr_SetString(PyExc_RuntimeError, "Reference parameter is no longer available, it can be accessed only during the call");
+				return false;
+			}
+			return true;
+		}
+
+		bool CheckRefVector(const NativeRefObject* ref) {
+			if (!CheckRefData(ref)) {
+				return false;
+			}
+			if (!ref->ops->size) {
+				PyErr_SetString(PyExc_TypeError, "Reference to a single value has no elements, use value");
+				return false;
+			}
+			return true;
+		}
+
+		void NativeRefDealloc(PyObject* self) {
+			PyTypeObject* const type = Py_TYPE(self);
+			type->tp_free(self);
+			Py_DECREF(type);
+		}
+
+		PyObject* NativeRefGetValue(PyObject* self, void*) {
+			const NativeRefObject* const ref = AsNativeRef(self);
+			if (!CheckRefData(ref)) {
+				return nullptr;
+			}
+			return ref->ops->get(ref->data);
+		}
+
+		int NativeRefSetValue(PyObject* self, PyObject* value, void*) {
+			NativeRefObject* const ref = AsNativeRef(self);
+			if (!value) {
+				PyErr_SetString(PyExc_AttributeError, "Reference value can't be deleted");
+				return -1;
+			}
+			if (!CheckRefData(ref)) {
+				return -1;
+			}
+			return ref->ops->set(ref->data, value) ? 0 : -1;
+		}
+
+		Py_ssize_t NativeRefLength(PyObject* self) {
+			const NativeRefObject* const ref = AsNativeRef(self);
+			if (!CheckRefVector(ref)) {
+				return -1;
+			}
+			return ref->ops->size(ref->data);
+		}
+
+		bool CheckRefIndex(const NativeRefObject* ref, Py_ssize_t index) {
+			if (index < 0 || index >= ref->ops->size(ref->data)) {
+				PyErr_SetString(PyExc_IndexError, "Ref index out of range");
+				return false;
+			}
+			return true;
+		}
+
+		PyObject* NativeRefItem(PyObject* self, Py_ssize_t index) {
+			const NativeRefObject* const ref = AsNativeRef(self);
+			if (!CheckRefVector(ref) || !CheckRefIndex(ref, index)) {
+				return nullptr;
+			}
+			return ref->ops->getItem(ref->data, index);
+		}
+
+		int NativeRefAssignItem(PyObject* self, Py_ssize_t index, PyObject* value) {
+			NativeRefObject* const ref = AsNativeRef(self);
+			if (!value) {
+				PyErr_SetString(PyExc_TypeError, "Ref elements can't be deleted, assign value instead");
+				return -1;
+			}
+			if (!CheckRefVector(ref) || !CheckRefIndex(ref, index)) {
+				return -1;
+			}
+			return ref->ops->setItem(ref->data, index, value) ? 0 : -1;
+		}
+
+		// Returns index adjusted for negative values, -1 with error set for invalid keys
+		Py_ssize_t RefSubscriptIndex(const NativeRefObject* ref, PyObject* key) {
+			if (!PyIndex_Check(key)) {
+				PyErr_Format(PyExc_TypeError, "Ref indices must be integers, not %.200s", Py_TYPE(key)->tp_name);
+				return -1;
+			}
+			Py_ssize_t index = PyNumber_AsSsize_t(key, PyExc_IndexError);
+			if (index == -1 && PyErr_Occurred()) {
+				return -1;
+			}
+			if (index < 0) {
+				index += ref->ops->size(ref->data);
+			}
+			if (!CheckRefIndex(ref, index)) {
+				return -1;
+			}
+			return index;
+		}
+
+		PyObject* NativeRefSubscript(PyObject* self, PyObject* key) {
+			const NativeRefObject* const ref = AsNativeRef(self);
+			if (!CheckRefVector(ref)) {
+				return nullptr;
+			}
+			if (PySlice_Check(key)) {
+				Py_ssize_t start, stop, step;
+				if (PySlice_Unpack(key, &start, &stop, &step) < 0) {
+					return nullptr;
+				}
+				const Py_ssize_t length = PySlice_AdjustIndices(ref->ops->size(ref->data), &start, &stop, step);
+				PyObject* const result = PyList_New(length);
+				if (!result) {
+					return nullptr;
+				}
+				for (Py_ssize_t i = 0, index = start; i < length; ++i, index += step) {
+					PyObject* const item = ref->ops->getItem(ref->data, index);
+					if (!item) {
+						Py_DECREF(result);
+						return nullptr;
+					}
+					PyList_SET_ITEM(result, i, item);
+				}
+				return result;
+			}
+			const Py_ssize_t index = RefSubscriptIndex(ref, key);
+			if (index < 0) {
+				return nullptr;
+			}
+			return ref->ops->getItem(ref->data, index);
+		}
+
+		int NativeRefAssignSubscript(PyObject* self, PyObject* key, PyObject* value) {
+			NativeRefObject* const ref = AsNativeRef(self);
+			if (!value) {
+				PyErr_SetString(PyExc_TypeError, "Ref elements can't be deleted, assign value instead");
+				return -1;
+			}
+			if (!CheckRefVector(ref)) {
+				return -1;
+			}
+			const Py_ssize_t index = RefSubscriptIndex(ref, key);
+			if (index < 0) {
+				return -1;
+			}
+			return ref->ops->setItem(ref->data, index, value) ? 0 : -1;
+		}
+
+		int NativeRefBool(PyObject* self) {
+			const NativeRefObject* const ref = AsNativeRef(self);
+			if (!CheckRefData(ref)) {
+				return -1;
+			}
+			if (ref->ops->size) {
+				return ref->ops->size(ref->data) != 0;
+			}
+			PyObject* const value = ref->ops->get(ref->data);
+			if (!value) {
+				return -1;
+			}
+			const int result = PyObject_IsTrue(value);
+			Py_DECREF(value);
+			return result;
+		}
+
+		PyObject* NativeRefRepr(PyObject* self) {
+			const NativeRefObject* const ref = AsNativeRef(self);
+			if (!ref->data) {
+				return PyUnicode_FromString("<Ref detached>");
+			}
+			PyObject* const value = ref->ops->get(ref->data);
+			if (!value) {
+				return nullptr;
+			}
+			PyObject* const result = PyUnicode_FromFormat("Ref(%R)", value);
+			Py_DECREF(value);
+			return result;
+		}
+
+		std::array<PyGetSetDef, 2> NativeRefGetSet = {{
+			{ "value", &NativeRefGetValue, &NativeRefSetValue, "Referenced value, assignment writes it back to native memory", nullptr },
+			{ nullptr, nullptr, nullptr, nullptr, nullptr }
+		}};
+
+		std::array<PyType_Slot, 12> NativeRefSlots = {{
+			{ Py_tp_dealloc, reinterpret_cast<void*>(&NativeRefDealloc) },
+			{ Py_tp_repr, reinterpret_cast<void*>(&NativeRefRepr) },
+			{ Py_tp_getset, NativeRefGetSet.data() },
+			{ Py_nb_bool, reinterpret_cast<void*>(&NativeRefBool) },
+			{ Py_sq_length, reinterpret_cast<void*>(&NativeRefLength) },
+			{ Py_sq_item, reinterpret_cast<void*>(&NativeRefItem) },
+			{ Py_sq_ass_item, reinterpret_cast<void*>(&NativeRefAssignItem) },
+			{ Py_mp_length, reinterpret_cast<void*>(&NativeRefLength) },
+			{ Py_mp_subscript, reinterpret_cast<void*>(&NativeRefSubscript) },
+			{ Py_mp_ass_subscript, reinterpret_cast<void*>(&NativeRefAssignSubscript) },
+			{ Py_tp_doc, const_cast<char*>(
+				"Reference parameter of a callback marked with plugify.refs.views.\n\n"
+				"value reads and assigns the whole value, elements of arrays are also accessed by index.") },
+			{ 0, nullptr }
+		}};
+
+		PyType_Spec NativeRefSpec = {
+			"plugify._core.Ref",
+			sizeof(NativeRefObject),
+			0,
+			Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+			NativeRefSlots.data()
+		};
+
+		//
+		// Plugin, PluginInfo
+		//
+
+		struct PluginObject {
+			PyObject_HEAD
+			PyObject* dict;
+		};
+
+		constexpr std::array PluginFields = {
+			"id", "name", "full_name", "description", "version", "author",
+			"website", "base_dir", "configs_dir", "data_dir", "logs_dir", "dependencies"
+		};
+
+		int PluginTraverse(PyObject* self, visitproc visit, void* arg) {
+			Py_VISIT(reinterpret_cast<PluginObject*>(self)->dict);
+			Py_VISIT(Py_TYPE(self));
+			return 0;
+		}
+
+		int PluginClear(PyObject* self) {
+			Py_CLEAR(reinterpret_cast<PluginObject*>(self)->dict);
+			return 0;
+		}
+
+		void PluginDealloc(PyObject* self) {
+			PyTypeObject* const type = Py_TYPE(self);
+			PyObject_GC_UnTrack(self);
+			PluginClear(self);
+			type->tp_free(self);
+			Py_DECREF(type);
+		}
+
+		int PluginInit(PyObject* self, PyObject* args, PyObject* kwargs) {
+			static std::array<char*, PluginFields.size() + 1> kwlist = []<size_t... I>(std::index_sequence<I...>) {
+				return std::array<char*, PluginFields.size() + 1>{ const_cast<char*>(PluginFields[I])..., nullptr };
+			}(std::make_index_sequence<PluginFields.size()>{});
+			std::array<PyObject*, PluginFields.size()> values{};
+			const int result = [&]<size_t... I>(std::index_sequence<I...>) {
+				return PyArg_ParseTupleAndKeywords(args, kwargs, "OOOOOOOOOOOO:Plugin", kwlist.data(), &values[I]...);
+			}(std::make_index_sequence<PluginFields.size()>{});
+			if (!result) {
+				return -1;
+			}
+			for (size_t i = 0; i < PluginFields.size(); ++i) {
+				if (PyObject_SetAttrString(self, PluginFields[i], values[i]) < 0) {
+					return -1;
+				}
+			}
+			return 0;
+		}
+
+		std::array<PyMemberDef, 2> PluginMembers = {{
+			{ "__dictoffset__", Py_T_PYSSIZET, offsetof(PluginObject, dict), Py_READONLY, nullptr },
+			{ nullptr, 0, 0, 0, nullptr }
+		}};
+
+		std::array<PyGetSetDef, 2> PluginGetSet = {{
+			{ "__dict__", &PyObject_GenericGetDict, &PyObject_GenericSetDict, nullptr, nullptr },
+			{ nullptr, nullptr, nullptr, nullptr, nullptr }
+		}};
+
+		std::array<PyType_Slot, 9> PluginSlots = {{
+			{ Py_tp_new, reinterpret_cast<void*>(&PyType_GenericNew) },
+			{ Py_tp_init, reinterpret_cast<void*>(&PluginInit) },
+			{ Py_tp_dealloc, reinterpret_cast<void*>(&PluginDealloc) },
+			{ Py_tp_traverse, reinterpret_cast<void*>(&PluginTraverse) },
+			{ Py_tp_clear, reinterpret_cast<void*>(&PluginClear) },
+			{ Py_tp_members, PluginMembers.data() },
+			{ Py_tp_getset, PluginGetSet.data() },
+			{ Py_tp_doc, const_cast<char*>(
+				"Base class of python plugins.\n\n"
+				"Update scheduling, read by the language module when the plugin starts:\n"
+				"  update_rate     - plugin_update calls per second, 0 means every frame\n"
+				"  update_interval - call plugin_update every N frames, used when update_rate is 0\n"
+				"  update_budget   - plugin_update time budget in seconds, 0 means unlimited.\n"
+				"                    A plugin which overran its budget skips the next scheduled update") },
+			{ 0, nullptr }
+		}};
+
+		PyType_Spec PluginSpec = {
+			"plugify._core.Plugin",
+			sizeof(PluginObject),
+			0,
+			Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+			PluginSlots.data()
+		};
+
+		struct PluginInfoObject {
+			PyObject_HEAD
+			PyObject* className;
+			PyObject* instance;
+		};
+
+		int PluginInfoTraverse(PyObject* self, visitproc visit, void* arg) {
+			auto* const info = reinterpret_cast<PluginInfoObject*>(self);
+			Py_VISIT(info->className);
+			Py_VISIT(info->instance);
+			Py_VISIT(Py_TYPE(self));
+			return 0;
+		}
+
+		int PluginInfoClear(PyObject* self) {
+			auto* const info = reinterpret_cast<PluginInfoObject*>(self);
+			Py_CLEAR(info->className);
+			Py_CLEAR(info->instance);
+			return 0;
+		}
+
+		void PluginInfoDealloc(PyObject* self) {
+			PyTypeObject* const type = Py_TYPE(self);
+			PyObject_GC_UnTrack(self);
+			PluginInfoClear(self);
+			type->tp_free(self);
+			Py_DECREF(type);
+		}
+
+		int PluginInfoInit(PyObject* self, PyObject* args, PyObject* kwargs) {
+			static std::array kwlist = { const_cast<char*>("class_name"), const_cast<char*>("instance"), static_cast<char*>(nullptr) };
+			PyObject* className = nullptr;
+			PyObject* instance = nullptr;
+			if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO:PluginInfo", kwlist.data(), &className, &instance)) {
+				return -1;
+			}
+			auto* const info = reinterpret_cast<PluginInfoObject*>(self);
+			Py_XSETREF(info->className, Py_NewRef(className));
+			Py_XSETREF(info->instance, Py_NewRef(instance));
+			return 0;
+		}
+
+		std::array<PyMemberDef, 3> PluginInfoMembers = {{
+			{ "class_name", Py_T_OBJECT_EX, offsetof(PluginInfoObject, className), 0, nullptr },
+			{ "instance", Py_T_OBJECT_EX, offsetof(PluginInfoObject, instance), 0, nullptr },
+			{ nullptr, 0, 0, 0, nullptr }
+		}};
+
+		std::array<PyType_Slot, 7> PluginInfoSlots = {{
+			{ Py_tp_new, reinterpret_cast<void*>(&PyType_GenericNew) },
+			{ Py_tp_init, reinterpret_cast<void*>(&PluginInfoInit) },
+			{ Py_tp_dealloc, reinterpret_cast<void*>(&PluginInfoDealloc) },
+			{ Py_tp_traverse, reinterpret_cast<void*>(&PluginInfoTraverse) },
+			{ Py_tp_clear, reinterpret_cast<void*>(&PluginInfoClear) },
+			{ Py_tp_members, PluginInfoMembers.data() },
+			{ 0, nullptr }
+		}};
+
+		PyType_Spec PluginInfoSpec = {
+			"plugify._core.PluginInfo",
+			sizeof(PluginInfoObject),
+			0,
+			Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+			PluginInfoSlots.data()
+		};
+
+		PyModuleDef CoreModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify._core",
+			"Plugify core types",
+			-1,
+			nullptr
+		};
+
+		PyTypeObject* AddType(PyObject* module, PyType_Spec* spec) {
+			PyObject* const type = PyType_FromModuleAndSpec(module, spec, nullptr);
+			if (!type) {
+				return nullptr;
+			}
+			// Module keeps type alive
+			const int result = PyModule_AddType(module, reinterpret_cast<PyTypeObject*>(type));
+			Py_DECREF(type);
+			return result == 0 ? reinterpret_cast<PyTypeObject*>(type) : nullptr;
+		}
+	}
+
+	PyObject* InitCoreModule() {
+		PyObject* const module = PyModule_Create(&CoreModuleDef);
+		if (!module) {
+			return nullptr;
+		}
+
+		PyTypeObject* const pluginType = AddType(module, &PluginSpec);
+		if (!pluginType) {
+			Py_DECREF(module);
+			return nullptr;
+		}
+
+		constexpr std::array<std::pair<const char*, long>, 3> pluginDefaults = {{
+			{ "update_rate", 0 },
+			{ "update_interval", 1 },
+			{ "update_budget", 0 }
+		}};
+		for (const auto& [name, value] : pluginDefaults) {
+			PyObject* const valueObject = PyLong_FromLong(value);
+			const int result = valueObject ? PyObject_SetAttrString(reinterpret_cast<PyObject*>(pluginType), name, valueObject) : -1;
+			Py_XDECREF(valueObject);
+			if (result < 0) {
+				Py_DECREF(module);
+				return nullptr;
+			}
+		}
+
+		if (!AddType(module, &PluginInfoSpec)) {
+			Py_DECREF(module);
+			return nullptr;
+		}
+
+		VectorTypes[2] = AddType(module, VectorSpec<2>());
+		VectorTypes[3] = AddType(module, VectorSpec<3>());
+		VectorTypes[4] = AddType(module, VectorSpec<4>());
+		Matrix4x4Type = AddType(module, &MatrixSpec);
+		NativeArrayType = AddType(module, &NativeArraySpec);
+		NativeRefType = AddType(module, &NativeRefSpec);
+		if (!VectorTypes[2] || !VectorTypes[3] || !VectorTypes[4] || !Matrix4x4Type || !NativeArrayType || !NativeRefType) {
+			Py_DECREF(module);
+			return nullptr;
+		}
+
+		return module;
+	}
+
+	PyObject* CreateNativeArray(void* data, Py_ssize_t size, const NativeArrayOps* ops, bool owned) {
+		PyObject* const object = NativeArrayType->tp_alloc(NativeArrayType, 0);
+		if (!object) {
+			if (owned) {
+				ops->destroy(data);
+			}
+			return nullptr;
+		}
+		NativeArrayObject* const array = AsNativeArray(object);
+		array->data = data;
+		array->ops = ops;
+		array->size = size;
+		array->owned = owned;
+		return object;
+	}
+
+	void DetachNativeArray(PyObject* object) {
+		NativeArrayObject* const array = AsNativeArray(object);
+		if (array->owned || !array->data) {
+			return;
+		}
+		// Nobody else can reach the elements when the caller holds the only reference
+		array->data = Py_REFCNT(object) > 1 ? array->ops->copy(array->data) : nullptr;
+		array->owned = array->data != nullptr;
+	}
+
+	bool IsNativeArray(PyObject* object) {
+		return Py_IS_TYPE(object, NativeArrayType);
+	}
+
+	void RefreshNativeArray(PyObject* object, Py_ssize_t size) {
+		NativeArrayClear(object);
+		AsNativeArray(object)->size = size;
+	}
+
+	PyObject* CreateNativeRef(void* data, const NativeRefOps* ops) {
+		PyObject* const object = NativeRefType->tp_alloc(NativeRefType, 0);
+		if (!object) {
+			return nullptr;
+		}
+		NativeRefObject* const ref = AsNativeRef(object);
+		ref->data = data;
+		ref->ops = ops;
+		return object;
+	}
+
+	void DetachNativeRef(PyObject* object) {
+		AsNativeRef(object)->data = nullptr;
+	}
+
+	bool IsNativeRef(PyObject* object) {
+		return Py_IS_TYPE(object, NativeRefType);
+	}
+}
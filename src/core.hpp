@@ -0,0 +1,80 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstddef>
+
+namespace py3lm {
+	// Layouts of plugify._core objects, also used by marshalling for direct field access
+
+	template<size_t N>
+	struct VectorObject {
+		PyObject_HEAD
+		double data[N];
+	};
+
+	using Vector2Object = VectorObject<2>;
+	using Vector3Object = VectorObject<3>;
+	using Vector4Object = VectorObject<4>;
+
+	struct Matrix4x4Object {
+		PyObject_HEAD
+		PyObject* m; // list of 4 rows, mutable by plugins as in pure python version
+	};
+
+	// Element access of a native vector behind plugify._core.NativeArray, provided by marshalling per element type
+	struct NativeArrayOps {
+		PyObject* (*item)(const void* data, Py_ssize_t index); // returns new reference
+		void* (*copy)(const void* data);
+		void (*destroy)(void* data);
+		const void* (*buffer)(const void* data); // nullptr when elements are not plain values
+		const char* format;
+		Py_ssize_t itemSize; // size of a scalar of format
+		Py_ssize_t shape[2]; // scalars per element in extra dimensions, 0 when unused
+	};
+
+	struct NativeArrayObject {
+		PyObject_HEAD
+		void* data; // nullptr once borrowed vector is gone and no copy was taken
+		const NativeArrayOps* ops;
+		PyObject** items; // elements converted so far
+		Py_ssize_t size;
+		Py_ssize_t exports; // buffers of owned data in use
+		bool owned;
+	};
+
+	// Read only sequence converting elements of a native vector on first access.
+	// Owned data of plain values is also exposed through the buffer protocol.
+	// Borrowed data has to be detached before the vector is destroyed.
+	PyObject* CreateNativeArray(void* data, Py_ssize_t size, const NativeArrayOps* ops, bool owned);
+	// Takes a copy of borrowed data when the array is referenced by anything besides the caller
+	void DetachNativeArray(PyObject* object);
+	bool IsNativeArray(PyObject* object);
+	// Drops converted elements after native code changed owned data
+	void RefreshNativeArray(PyObject* object, Py_ssize_t size);
+
+	// Access to a native value behind plugify._core.Ref, provided by marshalling per value type
+	struct NativeRefOps {
+		PyObject* (*get)(const void* data); // returns new reference
+		bool (*set)(void* data, PyObject* value); // sets error on failure
+		// Element access of vectors, nullptr for single values
+		Py_ssize_t (*size)(const void* data);
+		PyObject* (*getItem)(const void* data, Py_ssize_t index);
+		bool (*setItem)(void* data, Py_ssize_t index, PyObject* value);
+	};
+
+	struct NativeRefObject {
+		PyObject_HEAD
+		void* data; // nullptr once the call returned
+		const NativeRefOps* ops;
+	};
+
+	// Mutable view of a reference parameter, reads and writes go straight to native memory while the call lasts.
+	// No buffer is exported, since python could keep it after the native vector is gone.
+	PyObject* CreateNativeRef(void* data, const NativeRefOps* ops);
+	void DetachNativeRef(PyObject* object);
+	bool IsNativeRef(PyObject* object);
+
+	// Built-in plugify._core module, registered with PyImport_AppendInittab before interpreter init
+	PyObject* InitCoreModule();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace py3lm {
+	// Value to member lookup for enums: dense array when values form a compact range, flat open-addressing hash otherwise.
+	template<typename T>
+	class EnumTable {
+	public:
+		void Build(std::vector<std::pair<int64_t, T>> members) {
+			_dense.clear();
+			_slots.clear();
+			if (members.empty()) {
+				return;
+			}
+
+			std::sort(members.begin(), members.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+			_min = members.front().first;
+			_first = members.front().second;
+
+			const uint64_t span = static_cast<uint64_t>(members.back().first) - static_cast<uint64_t>(_min);
+			if (span < kMaxDenseSpan && span < members.size() * kMaxDenseRatio) {
+				_dense.resize(static_cast<size_t>(span) + 1);
+				for (const auto& [value, member] : members) {
+					_dense[static_cast<size_t>(static_cast<uint64_t>(value) - static_cast<uint64_t>(_min))] = member;
+				}
+				return;
+			}
+
+			size_t capacity = 8;
+			while (capacity < members.size() * 2) {
+				capacity <<= 1;
+			}
+			_slots.resize(capacity);
+			_mask = capacity - 1;
+			for (const auto& [value, member] : members) {
+				size_t index = Hash(value) & _mask;
+				while (_slots[index].member && _slots[index].value != value) {
+					index = (index + 1) & _mask;
+				}
+				_slots[index] = { value, member };
+			}
+		}
+
+		// Returns nullptr when value is not a member
+		T Find(int64_t value) const {
+			if (!_dense.empty()) {
+				const uint64_t offset = static_cast<uint64_t>(value) - static_cast<uint64_t>(_min);
+				return offset < _dense.size() ? _dense[static_cast<size_t>(offset)] : T{};
+			}
+			if (_slots.empty()) {
+				return T{};
+			}
+			size_t index = Hash(value) & _mask;
+			while (_slots[index].member) {
+				if (_slots[index].value == value) {
+					return _slots[index].member;
+				}
+				index = (index + 1) & _mask;
+			}
+			return T{};
+		}
+
+		// Values outside of the enum map to the member with the lowest value
+		T Get(int64_t value) const {
+			const T member = Find(value);
+			return member ? member : _first;
+		}
+
+		template<typename F>
+		void ForEach(F&& func) const {
+			for (const T& member : _dense) {
+				if (member) {
+					func(member);
+				}
+			}
+			for (const Slot& slot : _slots) {
+				if (slot.member) {
+					func(slot.member);
+				}
+			}
+		}
+
+	private:
+		static constexpr uint64_t kMaxDenseSpan = 4096;
+		static constexpr uint64_t kMaxDenseRatio = 4;
+
+		struct Slot {
+			int64_t value{};
+			T member{};
+		};
+
+		static size_t Hash(int64_t value) {
+			uint64_t x = static_cast<uint64_t>(value);
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdULL;
+			x ^= x >> 33;
+			return static_cast<size_t>(x);
+		}
+
+		std::vector<T> _dense;
+		std::vector<Slot> _slots;
+		int64_t _min{};
+		size_t _mask{};
+		T _first{};
+	};
+}
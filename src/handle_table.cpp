@@ -0,0 +1,88 @@
+#include "handle_table.hpp"
+
+namespace py3lm {
+	static_assert(sizeof(void*) == 8, "Object handles require 64-bit pointers");
+
+	void* HandleTable::MakeHandle(uint32_t index, uint32_t generation) {
+		const uintptr_t value = (static_cast<uintptr_t>(generation) << IndexBits) | index;
+		return reinterpret_cast<void*>((value << TagBits) | Tag);
+	}
+
+	const HandleTable::Slot* HandleTable::FindSlot(void* handle) const {
+		if (!IsHandle(handle)) {
+			return nullptr;
+		}
+		const auto value = reinterpret_cast<uintptr_t>(handle) >> TagBits;
+		const auto index = static_cast<uint32_t>(value & (MaxSlots - 1));
+		if (index >= _slots.size()) {
+			return nullptr;
+		}
+		const Slot& slot = _slots[index];
+		if (!slot.object || slot.generation != static_cast<uint32_t>(value >> IndexBits)) {
+			return nullptr;
+		}
+		return &slot;
+	}
+
+	void* HandleTable::Ref(PyObject* object) {
+		const auto [it, inserted] = _indices.try_emplace(object, 0);
+		if (!inserted) {
+			Slot& slot = _slots[it->second];
+			++slot.pins;
+			return MakeHandle(it->second, slot.generation);
+		}
+		uint32_t index;
+		if (_free.empty()) {
+			if (_slots.size() == MaxSlots) {
+				_indices.erase(it);
+				return nullptr;
+			}
+			index = static_cast<uint32_t>(_slots.size());
+			_slots.emplace_back();
+		} else {
+			index = _free.back();
+			_free.pop_back();
+		}
+		it->second = index;
+		Slot& slot = _slots[index];
+		slot.object = Py_NewRef(object);
+		slot.pins = 1;
+		return MakeHandle(index, slot.generation);
+	}
+
+	PyObject* HandleTable::Resolve(void* handle) const {
+		const Slot* const slot = FindSlot(handle);
+		return slot ? slot->object : nullptr;
+	}
+
+	bool HandleTable::Release(void* handle) {
+		auto* const slot = const_cast<Slot*>(FindSlot(handle));
+		if (!slot) {
+			return false;
+		}
+		if (--slot->pins != 0) {
+			return true;
+		}
+		const auto index = static_cast<uint32_t>(slot - _slots.data());
+		PyObject* const object = slot->object;
+		_indices.erase(object);
+		slot->object = nullptr;
+		if (slot->generation != MaxGeneration) {
+			++slot->generation;
+			_free.push_back(index);
+		}
+		// Object finalizer may use the table again, so it is released last
+		Py_DECREF(object);
+		return true;
+	}
+
+	void HandleTable::Clear() {
+		std::vector<Slot> slots;
+		slots.swap(_slots);
+		_free.clear();
+		_indices.clear();
+		for (const Slot& slot : slots) {
+			Py_XDECREF(slot.object);
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace py3lm {
+	// Table of python objects handed to native code as opaque pointer values.
+	// Handle keeps a strong reference to its object until the last pin is released,
+	// a released handle never resolves again even after its slot is reused.
+	class HandleTable {
+	public:
+		// Returns handle of object, registering it on first use, and pins it once more.
+		// Returns nullptr when every slot is in use.
+		void* Ref(PyObject* object);
+		// Returns borrowed reference or nullptr when value is not a live handle
+		PyObject* Resolve(void* handle) const;
+		// Returns false when value is not a live handle
+		bool Release(void* handle);
+		void Clear();
+
+		size_t Size() const { return _indices.size(); }
+
+		// Handles are canonical user space values with odd low bits, so they are never null
+		// and never match aligned pointers of real objects
+		static bool IsHandle(void* value) {
+			const auto bits = reinterpret_cast<uintptr_t>(value);
+			return (bits & TagMask) == Tag && (bits >> (TagBits + IndexBits + GenerationBits)) == 0;
+		}
+
+	private:
+		static constexpr uintptr_t Tag = 0x5;
+		static constexpr uintptr_t TagMask = 0x7;
+		static constexpr int TagBits = 3;
+		static constexpr int IndexBits = 24;
+		static constexpr int GenerationBits = 20;
+		static constexpr uint32_t MaxSlots = uint32_t{ 1 } << IndexBits;
+		// Slot is retired instead of reused once its generation would wrap
+		static constexpr uint32_t MaxGeneration = (uint32_t{ 1 } << GenerationBits) - 1;
+
+		struct Slot {
+			PyObject* object{};
+			uint32_t pins{};
+			uint32_t generation{};
+		};
+
+		static void* MakeHandle(uint32_t index, uint32_t generation);
+		const Slot* FindSlot(void* handle) const;
+
+		std::vector<Slot> _slots;
+		std::vector<uint32_t> _free;
+		std::unordered_map<PyObject*, uint32_t> _indices;
+	};
+}
@@ -1,8 +1,18 @@
 #include "module.hpp"
+#include "core.hpp"
+#include "process_memory.hpp"
+#include "utf16.hpp"
 #include <array>
+#include <bit>
 #include <climits>
 #include <cuchar>
 #include <bitset>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <marshal.h>
 #include <module_export.h>
 #include <plugify/compat_format.hpp>
 #include <plugify/log.hpp>
@@ -82,76 +92,43 @@ namespace py3lm {
 			return false;
 		}
 
-		// Return codes:
-		// [1, 3]	Number bytes used
-		// 0		Sequence starts with \0
-		// -1		Encoding error
-		// -2		Invalid multibyte sequence
-		// -3		Surrogate pair
-		std::pair<short, char16_t> ConvertUtf8ToUtf16(std::string_view sequence) {
-			const auto c8toc16 = [](char ch) -> char16_t { return static_cast<char16_t>(static_cast<uint8_t>(ch)); };
+		// Native functions wrapped by plugify option functions are bound to a capsule with their options
+		constexpr const char* CallOptionsCapsuleName = "plugify.call_options";
 
-			if (sequence.empty()) {
-				return { -2, {} };
-			}
-			const char seqCh0 = sequence[0];
-			if (seqCh0 == '\0') {
-				return { 0, 0 };
-			}
-			if ((seqCh0 & 0b11111000) == 0b11110000) {
-				return { -3, {} };
-			}
-			if ((seqCh0 & 0b11110000) == 0b11100000) {
-				if (sequence.size() < 3) {
-					return { -2, {} };
-				}
-				const char seqCh1 = sequence[1];
-				const char seqCh2 = sequence[2];
-				if ((seqCh1 & 0b11000000) != 0b10000000 || (seqCh2 & 0b11000000) != 0b10000000) {
-					return { -2, {} };
-				}
-				const char16_t ch = (c8toc16(seqCh0 & 0b00001111) << 12) | (c8toc16(seqCh1 & 0b00111111) << 6) | c8toc16(seqCh2 & 0b00111111);
-				if (0xD800 <= static_cast<uint16_t>(ch) && static_cast<uint16_t>(ch) < 0xE000) {
-					return { -1, {} };
-				}
-				return { 3, ch };
-			}
-			if ((seqCh0 & 0b11100000) == 0b11000000) {
-				if (sequence.size() < 2) {
-					return { -2, {} };
-				}
-				const char seqCh1 = sequence[1];
-				if ((seqCh1 & 0b11000000) != 0b10000000) {
-					return { -2, {} };
+		const CallOptions DefaultCallOptions{};
+
+		const CallOptions& GetCallOptions(PyObject* self) {
+			if (self && PyCapsule_CheckExact(self)) {
+				if (const auto* const options = static_cast<const CallOptions*>(PyCapsule_GetPointer(self, CallOptionsCapsuleName))) {
+					return *options;
 				}
-				return { 2, (c8toc16(seqCh0 & 0b00011111) << 6) | c8toc16(seqCh1 & 0b00111111) };
-			}
-			if ((seqCh0 & 0b10000000) == 0b00000000) {
-				return { 1, c8toc16(seqCh0) };
+				PyErr_Clear();
 			}
-			return { -1, {} };
+			return DefaultCallOptions;
 		}
 
-		// Return codes:
-		// [1, 3]	Number bytes returned
-		// 0		For 0x0000 symbol
-		// -1		Surrogate pair
-		std::pair<short, std::array<char, 4>> ConvertUtf16ToUtf8(char16_t ch16) {
-			const auto c16toc8 = [](char16_t ch) -> char { return static_cast<char>(static_cast<uint8_t>(ch)); };
+		// Options of the innermost native call or callback running on this thread
+		thread_local const CallOptions* currentCallOptions = &DefaultCallOptions;
 
-			if (ch16 == 0) {
-				return { 0, { } };
-			}
-			if (static_cast<uint16_t>(ch16) < 0x80) {
-				return { 1, { c16toc8(ch16), '\0' } };
-			}
-			if (static_cast<uint16_t>(ch16) < 0x800) {
-				return { 2, { c16toc8(((ch16 & 0b11111000000) >> 6) | 0b11000000), c16toc8((ch16 & 0b111111) | 0b10000000), '\0' } };
-			}
-			if (0xD800 <= static_cast<uint16_t>(ch16) && static_cast<uint16_t>(ch16) < 0xE000) {
-				return { -1, {} };
-			}
-			return { 3, { c16toc8(((ch16 & 0b1111000000000000) >> 12) | 0b11100000), c16toc8(((ch16 & 0b111111000000) >> 6) | 0b10000000), c16toc8((ch16 & 0b111111) | 0b10000000), '\0' } };
+		struct CallOptionsScope {
+			explicit CallOptionsScope(const CallOptions& options) : saved(std::exchange(currentCallOptions, &options)) {}
+			~CallOptionsScope() { currentCallOptions = saved; }
+			CallOptionsScope(const CallOptionsScope&) = delete;
+			CallOptionsScope& operator=(const CallOptionsScope&) = delete;
+
+			const CallOptions* saved;
+		};
+
+		// Native arrays and refs of callback parameters on this thread, detached when their callback returns
+		thread_local std::vector<PyObject*> borrowedObjects;
+
+		void TrackBorrowedObject(PyObject* object) {
+			borrowedObjects.push_back(object);
+		}
+
+		bool UseLazyArray(size_t size) {
+			const size_t minSize = currentCallOptions->lazyArrayMinSize;
+			return minSize != 0 && size >= minSize;
 		}
 
 		// Generic function to check if value is in range of type N
@@ -241,8 +218,12 @@ namespace py3lm {
 
 		template<>
 		std::optional<bool> ValueFromObject(PyObject* object) {
-			if (PyBool_Check(object)) {
-				return object == Py_True;
+			// bool can't be subclassed, so singletons are the only instances
+			if (object == Py_True) {
+				return true;
+			}
+			if (object == Py_False) {
+				return false;
 			}
 			SetTypeError("Expected boolean", object);
 			return std::nullopt;
@@ -275,28 +256,17 @@ namespace py3lm {
 		template<>
 		std::optional<char16_t> ValueFromObject(PyObject* object) {
 			if (PyUnicode_Check(object)) {
-				const Py_ssize_t length = PyUnicode_GetLength(object);
+				const Py_ssize_t length = PyUnicode_GET_LENGTH(object);
 				if (length == 0) {
 					return 0;
 				}
 				if (length == 1) {
-					auto [rc, ch] = ConvertUtf8ToUtf16(PyUnicode_AsString(object));
-					switch (rc) {
-					case 0:
-					case 1:
-					case 2:
-					case 3:
-						return ch;
-					case -3:
-						PyErr_SetString(PyExc_ValueError, "Surrogate pair");
-						break;
-					case -2:
-						PyErr_SetString(PyExc_ValueError, "Invalid multibyte character");
-						break;
-					case -1:
-						PyErr_SetString(PyExc_RuntimeError, "Encoding error");
-						break;
+					// Code point is read from str storage directly, no UTF-8 round trip
+					const Py_UCS4 ch = PyUnicode_READ_CHAR(object, 0);
+					if (ch <= 0xFFFF) {
+						return static_cast<char16_t>(ch);
 					}
+					PyErr_SetString(PyExc_ValueError, "Surrogate pair");
 				}
 				else {
 					PyErr_SetString(PyExc_ValueError, "Length bigger than 1");
@@ -310,40 +280,63 @@ namespace py3lm {
 		template<typename T>
 		std::optional<T> GetObjectAttrAsValue(PyObject* object, const char* attr_name);
 
+		template<class ValueType, class CType, CType (*ConvertFunc)(PyObject*)>
+		std::optional<ValueType> ValueFromLongObject(PyObject* object) {
+			// Small ints, bools and enum members are compact, read the digit directly
+			const auto* const longObject = reinterpret_cast<PyLongObject*>(object);
+			if (PyUnstable_Long_IsCompact(longObject)) {
+				const Py_ssize_t compactResult = PyUnstable_Long_CompactValue(longObject);
+				if (IsInRange<Py_ssize_t, ValueType>(compactResult)) {
+					return static_cast<ValueType>(compactResult);
+				}
+				PyErr_SetNone(PyExc_OverflowError);
+				return std::nullopt;
+			}
+			const CType castResult = ConvertFunc(object);
+			if (castResult == static_cast<CType>(-1) && PyErr_Occurred()) {
+				return std::nullopt;
+			}
+			if (IsInRange<CType, ValueType>(castResult)) {
+				return static_cast<ValueType>(castResult);
+			}
+			PyErr_SetNone(PyExc_OverflowError);
+			return std::nullopt;
+		}
+
 		template<class ValueType, class CType, CType (*ConvertFunc)(PyObject*)> requires(std::is_signed_v<ValueType> || std::is_unsigned_v<ValueType>)
 		std::optional<ValueType> ValueFromNumberObject(PyObject* object) {
-			// int or IntEnum
+			// int, bool or IntEnum
 			if (PyLong_Check(object)) {
-				const CType castResult = ConvertFunc(object);
-				if (!PyErr_Occurred()) {
-					if (IsInRange<CType, ValueType>(castResult)) {
-						return static_cast<ValueType>(castResult);
-					}
-					PyErr_SetNone(PyExc_OverflowError);
-				}
-				return std::nullopt;
+				return ValueFromLongObject<ValueType, CType, ConvertFunc>(object);
 			}
 			// Enum
 			else if (PyObject_TypeCheck(object, &PyEnum_Type)) {
 				PyObject* value = PyObject_GetAttrString(object, "value");
 				if (value) {
+					std::optional<ValueType> result;
 					if (PyLong_Check(value)) {
-						const CType castResult = ConvertFunc(value);
-						if (!PyErr_Occurred()) {
-							if (IsInRange<CType, ValueType>(castResult)) {
-								Py_DECREF(value);
-								return static_cast<ValueType>(castResult);
-							}
-							PyErr_SetNone(PyExc_OverflowError);
-						}
+						result = ValueFromLongObject<ValueType, CType, ConvertFunc>(value);
+					} else {
+						SetTypeError("Expected enum with integer value", value);
 					}
 					Py_DECREF(value);
+					return result;
 				} else {
 					PyErr_Clear();
 					SetTypeError("Expected enum with 'value' attribute", object);
 				}
 				return std::nullopt;
 			}
+			// Objects implementing __index__, e.g. numpy integers
+			else if (PyIndex_Check(object)) {
+				PyObject* const index = PyNumber_Index(object);
+				if (!index) {
+					return std::nullopt;
+				}
+				const auto result = ValueFromLongObject<ValueType, CType, ConvertFunc>(index);
+				Py_DECREF(index);
+				return result;
+			}
 
 			SetTypeError("Expected integer", object);
 			return std::nullopt;
@@ -351,14 +344,13 @@ namespace py3lm {
 
 		template<class ValueType> requires(std::is_floating_point_v<ValueType>)
 		std::optional<ValueType> ValueFromFloatObject(PyObject* object) {
+			// float stores its value inline, no conversion call or error check is needed
 			if (PyFloat_Check(object)) {
 				const double castResult = PyFloat_AS_DOUBLE(object);
-				if (!PyErr_Occurred()) {
-					if (IsInRange<double, ValueType>(castResult)) {
-						return static_cast<ValueType>(castResult);
-					}
-					PyErr_SetNone(PyExc_OverflowError);
+				if (IsInRange<double, ValueType>(castResult)) {
+					return static_cast<ValueType>(castResult);
 				}
+				PyErr_SetNone(PyExc_OverflowError);
 				return std::nullopt;
 			}
 			SetTypeError("Expected float", object);
@@ -412,13 +404,17 @@ namespace py3lm {
 
 		template<>
 		std::optional<void*> ValueFromObject(PyObject* object) {
+			if (object == Py_None) {
+				return nullptr;
+			}
 			if (PyLong_Check(object)) {
 				const auto result = PyLong_AsVoidPtr(object);
 				if (!PyErr_Occurred()) {
 					return result;
 				}
 			}
-			SetTypeError("Expected integer", object);
+			// Objects are passed as pointers only through explicit plugify.handles.ref()
+			SetTypeError("Expected integer or None", object);
 			return std::nullopt;
 		}
 
@@ -432,18 +428,36 @@ namespace py3lm {
 			return ValueFromFloatObject<double>(object);
 		}
 
-		template<>
-		std::optional<plg::string> ValueFromObject(PyObject* object) {
+		// UTF-8 of str, or contents of bytes as is, valid while object is alive
+		std::optional<std::string_view> StringViewFromObject(PyObject* object) {
 			if (PyUnicode_Check(object)) {
-				return PyUnicode_AsString(object);
+				Py_ssize_t size;
+				const char* const data = PyUnicode_AsUTF8AndSize(object, &size);
+				if (!data) {
+					return std::nullopt;
+				}
+				return std::string_view(data, static_cast<size_t>(size));
+			}
+			if (PyBytes_Check(object)) {
+				return std::string_view(PyBytes_AS_STRING(object), static_cast<size_t>(PyBytes_GET_SIZE(object)));
 			}
 			SetTypeError("Expected string", object);
 			return std::nullopt;
 		}
 
+		template<>
+		std::optional<plg::string> ValueFromObject(PyObject* object) {
+			if (const auto view = StringViewFromObject(object)) {
+				return plg::string(*view);
+			}
+			return std::nullopt;
+		}
+
 		template<typename T>
 		std::optional<plg::vector<T>> ArrayFromObject(PyObject* arrayObject);
 
+		std::optional<plg::any> AnyArrayFromList(PyObject* listObject);
+
 		template<>
 		std::optional<plg::any> ValueFromObject(PyObject* object) {
 			auto [type, name] = g_py3lm.GetObjectType(object);
@@ -457,94 +471,8 @@ namespace py3lm {
 				case PyAbstractType::Unicode: {
 					return PyUnicode_AsString(object);
 				}
-				case PyAbstractType::List: {
-					const Py_ssize_t size = PyList_Size(object);
-					if (size == 0) {
-						return plg::vector<int64_t>();
-					}
-					std::bitset<MaxPyTypes> flags;
-					for (Py_ssize_t i = 0; i < size; i++) {
-						PyObject* const valueObject = PyList_GetItem(object, i);
-						if (valueObject) {
-							auto [valueType, _] = g_py3lm.GetObjectType(valueObject);
-							if (valueType != PyAbstractType::Invalid) {
-								flags.set(static_cast<size_t>(valueType));
-							}
-							continue;
-						}
-						return std::nullopt;
-					}
-					if (flags.count() == 1) {
-						const auto flag = static_cast<PyAbstractType>(FindBitSetIndex(flags));
-						switch (flag) {
-							case PyAbstractType::Long: {
-								if (auto array = ArrayFromObject<int64_t>(object)) {
-									return std::move(*array);
-								}
-								return std::nullopt;
-							}
-							case PyAbstractType::Bool: {
-								if (auto array = ArrayFromObject<bool>(object)) {
-									return std::move(*array);
-								}
-								return std::nullopt;
-							}
-							case PyAbstractType::Float: {
-								if (auto array = ArrayFromObject<double>(object)) {
-									return std::move(*array);
-								}
-								return std::nullopt;
-							}
-							case PyAbstractType::Unicode: {
-								if (auto array = ArrayFromObject<plg::string>(object)) {
-									return std::move(*array);
-								}
-								return std::nullopt;
-							}
-							case PyAbstractType::Vector2: {
-								if (auto array = ArrayFromObject<plg::vec2>(object)) {
-									return std::move(*array);
-								}
-								return std::nullopt;
-							}
-							case PyAbstractType::Vector3: {
-								if (auto array = ArrayFromObject<plg::vec3>(object)) {
-									return std::move(*array);
-								}
-								return std::nullopt;
-							}
-							case PyAbstractType::Vector4: {
-								if (auto array = ArrayFromObject<plg::vec4>(object)) {
-									return std::move(*array);
-								}
-								return std::nullopt;
-							}
-							case PyAbstractType::Matrix4x4: {
-								if (auto array = ArrayFromObject<plg::mat4x4>(object)) {
-									return std::move(*array);
-								}
-								return std::nullopt;
-							}
-							default:
-								break;
-						}
-					}
-					std::string error("List should contains supported types, but contains: [");
-					bool first = true;
-					for (Py_ssize_t i = 0; i < size; i++) {
-						PyObject* const valueObject = PyList_GetItem(object, i);
-						auto [_, valueName] = g_py3lm.GetObjectType(valueObject);
-						if (first) {
-							std::format_to(std::back_inserter(error), "'{}", valueName);
-							first = false;
-						} else {
-							std::format_to(std::back_inserter(error), "', '{}", valueName);
-						}
-					}
-					error += "']";
-					PyErr_SetString(PyExc_TypeError, error.c_str());
-					return std::nullopt;
-				}
+				case PyAbstractType::List:
+					return AnyArrayFromList(object);
 				case PyAbstractType::Vector2:
 					return g_py3lm.Vector2ValueFromObject(object);
 				case PyAbstractType::Vector3:
@@ -578,26 +506,334 @@ namespace py3lm {
 			return g_py3lm.Matrix4x4ValueFromObject(object);
 		}
 
+		// Conversion of an item may run python code (__index__, __float__), which can resize the list being converted
+		bool CheckListSize(PyObject* listObject, Py_ssize_t size) {
+			if (PySequence_Fast_GET_SIZE(listObject) != size) {
+				PyErr_SetString(PyExc_RuntimeError, "list changed size during conversion");
+				return false;
+			}
+			return true;
+		}
+
+		// Items of list or tuple are read in place, both keep them in a contiguous array.
+		// NativeArray of another element type is converted into a tuple first.
+		class SequenceItems {
+		public:
+			explicit SequenceItems(PyObject* arrayObject) {
+				if (PyList_Check(arrayObject) || PyTuple_Check(arrayObject)) {
+					_sequence = Py_NewRef(arrayObject);
+				} else if (IsNativeArray(arrayObject)) {
+					_sequence = PySequence_Tuple(arrayObject);
+				} else {
+					SetTypeError("Expected list, tuple or NativeArray", arrayObject);
+				}
+			}
+			~SequenceItems() {
+				Py_XDECREF(_sequence);
+			}
+			SequenceItems(const SequenceItems&) = delete;
+			SequenceItems& operator=(const SequenceItems&) = delete;
+
+			explicit operator bool() const { return _sequence != nullptr; }
+			PyObject* const* Items() const { return PySequence_Fast_ITEMS(_sequence); }
+			Py_ssize_t Size() const { return PySequence_Fast_GET_SIZE(_sequence); }
+			bool CheckSize(Py_ssize_t size) const { return CheckListSize(_sequence, size); }
+
+		private:
+			PyObject* _sequence = nullptr;
+		};
+
 		template<typename T>
-		std::optional<plg::vector<T>> ArrayFromObject(PyObject* arrayObject) {
-			if (!PyList_Check(arrayObject)) {
-				SetTypeError("Expected list", arrayObject);
+		constexpr bool IsCompactIntElement = std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, char16_t>;
+
+		// Converts leading items of exact types without error checks, returns index of first item left for ValueFromObject
+		template<typename T>
+		Py_ssize_t ConvertFastItems(PyObject* const* items, Py_ssize_t size, T* data) {
+			Py_ssize_t i = 0;
+			if constexpr (std::is_floating_point_v<T>) {
+				for (; i < size; ++i) {
+					PyObject* const item = items[i];
+					if (!PyFloat_CheckExact(item)) {
+						break;
+					}
+					const double value = PyFloat_AS_DOUBLE(item);
+					if constexpr (!std::is_same_v<T, double>) {
+						if (!IsInRange<double, T>(value)) {
+							break;
+						}
+					}
+					data[i] = static_cast<T>(value);
+				}
+			} else if constexpr (IsCompactIntElement<T>) {
+				for (; i < size; ++i) {
+					PyObject* const item = items[i];
+					if (!PyLong_CheckExact(item) || !PyUnstable_Long_IsCompact(reinterpret_cast<PyLongObject*>(item))) {
+						break;
+					}
+					const Py_ssize_t value = PyUnstable_Long_CompactValue(reinterpret_cast<PyLongObject*>(item));
+					if (!IsInRange<Py_ssize_t, T>(value)) {
+						break;
+					}
+					data[i] = static_cast<T>(value);
+				}
+			} else if constexpr (std::is_same_v<T, bool>) {
+				for (; i < size; ++i) {
+					PyObject* const item = items[i];
+					if (item != Py_True && item != Py_False) {
+						break;
+					}
+					data[i] = item == Py_True;
+				}
+			}
+			return i;
+		}
+
+		template<typename T>
+		std::optional<plg::vector<T>> ArrayFromList(PyObject* arrayObject) {
+			const SequenceItems sequence(arrayObject);
+			if (!sequence) {
 				return std::nullopt;
 			}
-			const Py_ssize_t size = PyList_Size(arrayObject);
-			plg::vector<T> array(static_cast<size_t>(size));
-			for (Py_ssize_t i = 0; i < size; ++i) {
-				if (PyObject* const valueObject = PyList_GetItem(arrayObject, i)) {
-					if (auto value = ValueFromObject<T>(valueObject)) {
-						array[static_cast<size_t>(i)] = std::move(*value);
-						continue;
+			const Py_ssize_t size = sequence.Size();
+			// Checked path holds the item and looks up items again, python code it runs may change the list
+			auto convertItem = [&sequence, size](Py_ssize_t i) -> std::optional<T> {
+				PyObject* const item = Py_NewRef(sequence.Items()[i]);
+				auto value = ValueFromObject<T>(item);
+				Py_DECREF(item);
+				if (!value || !sequence.CheckSize(size)) {
+					return std::nullopt;
+				}
+				return value;
+			};
+			if constexpr (std::is_arithmetic_v<T>) {
+				plg::vector<T> array(static_cast<size_t>(size));
+				T* const data = array.data();
+				Py_ssize_t i = 0;
+				while ((i += ConvertFastItems(sequence.Items() + i, size - i, data + i)) < size) {
+					// Items of other types (enums, numpy scalars) and out of range values take the checked path, which also reports errors
+					auto value = convertItem(i);
+					if (!value) {
+						return std::nullopt;
+					}
+					data[i++] = *value;
+				}
+				return array;
+			} else {
+				plg::vector<T> array;
+				array.reserve(static_cast<size_t>(size));
+				for (Py_ssize_t i = 0; i < size; ++i) {
+					auto value = convertItem(i);
+					if (!value) {
+						return std::nullopt;
 					}
+					array.emplace_back(std::move(*value));
 				}
+				return array;
+			}
+		}
+
+		template<typename T>
+		std::optional<plg::vector<T>> ArrayFromObject(PyObject* arrayObject) {
+			return ArrayFromList<T>(arrayObject);
+		}
+
+		// Strings are constructed once with exact size from UTF-8 buffers of str objects, without temporaries
+		template<>
+		std::optional<plg::vector<plg::string>> ArrayFromObject(PyObject* arrayObject) {
+			const SequenceItems sequence(arrayObject);
+			if (!sequence) {
 				return std::nullopt;
 			}
+			const Py_ssize_t size = sequence.Size();
+			plg::vector<plg::string> array;
+			array.reserve(static_cast<size_t>(size));
+			// Reading str and bytes runs no python code, so the list can't change while it is converted
+			for (Py_ssize_t i = 0; i < size; ++i) {
+				const auto view = StringViewFromObject(sequence.Items()[i]);
+				if (!view) {
+					return std::nullopt;
+				}
+				array.emplace_back(*view);
+			}
+			return array;
+		}
+
+		// Character arrays also accept a whole str, or bytes for char8, instead of a list of characters
+		template<>
+		std::optional<plg::vector<char>> ArrayFromObject(PyObject* arrayObject) {
+			if (PyUnicode_Check(arrayObject)) {
+				Py_ssize_t size;
+				if (const char* const data = PyUnicode_AsUTF8AndSize(arrayObject, &size)) {
+					return plg::vector<char>(data, data + size);
+				}
+				// Lone surrogates come from undecodable bytes of a char8 array marshalled as str
+				PyErr_Clear();
+				PyObject* const bytesObject = PyUnicode_AsEncodedString(arrayObject, "utf-8", "surrogateescape");
+				if (!bytesObject) {
+					return std::nullopt;
+				}
+				const char* const data = PyBytes_AS_STRING(bytesObject);
+				plg::vector<char> array(data, data + PyBytes_GET_SIZE(bytesObject));
+				Py_DECREF(bytesObject);
+				return array;
+			}
+			if (PyBytes_Check(arrayObject)) {
+				const char* const data = PyBytes_AS_STRING(arrayObject);
+				return plg::vector<char>(data, data + PyBytes_GET_SIZE(arrayObject));
+			}
+			if (PyByteArray_Check(arrayObject)) {
+				const char* const data = PyByteArray_AS_STRING(arrayObject);
+				return plg::vector<char>(data, data + PyByteArray_GET_SIZE(arrayObject));
+			}
+			return ArrayFromList<char>(arrayObject);
+		}
+
+		template<>
+		std::optional<plg::vector<char16_t>> ArrayFromObject(PyObject* arrayObject) {
+			if (!PyUnicode_Check(arrayObject)) {
+				return ArrayFromList<char16_t>(arrayObject);
+			}
+			const auto length = static_cast<size_t>(PyUnicode_GET_LENGTH(arrayObject));
+			switch (PyUnicode_KIND(arrayObject)) {
+				case PyUnicode_1BYTE_KIND: {
+					plg::vector<char16_t> array(length);
+					WidenLatin1(PyUnicode_1BYTE_DATA(arrayObject), length, array.data());
+					return array;
+				}
+				case PyUnicode_2BYTE_KIND: {
+					const auto* const data = reinterpret_cast<const char16_t*>(PyUnicode_2BYTE_DATA(arrayObject));
+					return plg::vector<char16_t>(data, data + length);
+				}
+				default: {
+					const auto* const data = reinterpret_cast<const uint32_t*>(PyUnicode_4BYTE_DATA(arrayObject));
+					plg::vector<char16_t> array(Utf16Length(data, length));
+					EncodeUtf16(data, length, array.data());
+					return array;
+				}
+			}
+		}
+
+		// Converts elements while their type matches the first one, mismatch is reported without setting error
+		template<typename T>
+		std::optional<plg::vector<T>> SpeculativeArrayFromList(PyObject* listObject, Py_ssize_t size, bool& mismatch) {
+			PyTypeObject* const expected = Py_TYPE(PyList_GET_ITEM(listObject, 0));
+			plg::vector<T> array;
+			array.reserve(static_cast<size_t>(size));
+			for (Py_ssize_t i = 0; i < size; ++i) {
+				PyObject* const valueObject = PyList_GET_ITEM(listObject, i);
+				if (Py_TYPE(valueObject) != expected) {
+					mismatch = true;
+					return std::nullopt;
+				}
+				Py_INCREF(valueObject);
+				auto value = ValueFromObject<T>(valueObject);
+				Py_DECREF(valueObject);
+				if (!value || !CheckListSize(listObject, size)) {
+					return std::nullopt;
+				}
+				array.emplace_back(std::move(*value));
+			}
 			return array;
 		}
 
+		template<typename T>
+		std::optional<plg::any> ToAnyArray(std::optional<plg::vector<T>>&& array) {
+			if (array) {
+				return std::move(*array);
+			}
+			return std::nullopt;
+		}
+
+		// Mixed lists: collect element types to find a single supported one or report all of them
+		std::optional<plg::any> AnyArrayFromMixedList(PyObject* listObject, Py_ssize_t size) {
+			std::bitset<MaxPyTypes + 1> flags;
+			for (Py_ssize_t i = 0; i < size; i++) {
+				auto [valueType, _] = g_py3lm.GetObjectType(PyList_GET_ITEM(listObject, i));
+				if (valueType != PyAbstractType::Invalid) {
+					flags.set(static_cast<size_t>(valueType));
+				}
+			}
+			if (flags.count() == 1) {
+				switch (static_cast<PyAbstractType>(FindBitSetIndex(flags))) {
+					case PyAbstractType::Long:
+						return ToAnyArray(ArrayFromObject<int64_t>(listObject));
+					case PyAbstractType::Bool:
+						return ToAnyArray(ArrayFromObject<bool>(listObject));
+					case PyAbstractType::Float:
+						return ToAnyArray(ArrayFromObject<double>(listObject));
+					case PyAbstractType::Unicode:
+						return ToAnyArray(ArrayFromObject<plg::string>(listObject));
+					case PyAbstractType::Vector2:
+						return ToAnyArray(ArrayFromObject<plg::vec2>(listObject));
+					case PyAbstractType::Vector3:
+						return ToAnyArray(ArrayFromObject<plg::vec3>(listObject));
+					case PyAbstractType::Vector4:
+						return ToAnyArray(ArrayFromObject<plg::vec4>(listObject));
+					case PyAbstractType::Matrix4x4:
+						return ToAnyArray(ArrayFromObject<plg::mat4x4>(listObject));
+					default:
+						break;
+				}
+			}
+			std::string error("List should contains supported types, but contains: [");
+			bool first = true;
+			for (Py_ssize_t i = 0; i < PyList_GET_SIZE(listObject); i++) {
+				auto [_, valueName] = g_py3lm.GetObjectType(PyList_GET_ITEM(listObject, i));
+				if (first) {
+					std::format_to(std::back_inserter(error), "'{}", valueName);
+					first = false;
+				} else {
+					std::format_to(std::back_inserter(error), "', '{}", valueName);
+				}
+			}
+			error += "']";
+			PyErr_SetString(PyExc_TypeError, error.c_str());
+			return std::nullopt;
+		}
+
+		std::optional<plg::any> AnyArrayFromList(PyObject* listObject) {
+			const Py_ssize_t size = PyList_GET_SIZE(listObject);
+			if (size == 0) {
+				return plg::vector<int64_t>();
+			}
+			// Guess element type from the first item and convert in one pass, lists are almost always homogeneous
+			bool mismatch = false;
+			std::optional<plg::any> result;
+			switch (g_py3lm.GetObjectType(PyList_GET_ITEM(listObject, 0)).type) {
+				case PyAbstractType::Long:
+					result = ToAnyArray(SpeculativeArrayFromList<int64_t>(listObject, size, mismatch));
+					break;
+				case PyAbstractType::Bool:
+					result = ToAnyArray(SpeculativeArrayFromList<bool>(listObject, size, mismatch));
+					break;
+				case PyAbstractType::Float:
+					result = ToAnyArray(SpeculativeArrayFromList<double>(listObject, size, mismatch));
+					break;
+				case PyAbstractType::Unicode:
+					result = ToAnyArray(SpeculativeArrayFromList<plg::string>(listObject, size, mismatch));
+					break;
+				case PyAbstractType::Vector2:
+					result = ToAnyArray(SpeculativeArrayFromList<plg::vec2>(listObject, size, mismatch));
+					break;
+				case PyAbstractType::Vector3:
+					result = ToAnyArray(SpeculativeArrayFromList<plg::vec3>(listObject, size, mismatch));
+					break;
+				case PyAbstractType::Vector4:
+					result = ToAnyArray(SpeculativeArrayFromList<plg::vec4>(listObject, size, mismatch));
+					break;
+				case PyAbstractType::Matrix4x4:
+					result = ToAnyArray(SpeculativeArrayFromList<plg::mat4x4>(listObject, size, mismatch));
+					break;
+				default:
+					mismatch = true;
+					break;
+			}
+			if (!mismatch) {
+				return result;
+			}
+			return AnyArrayFromMixedList(listObject, size);
+		}
+
 		std::optional<void*> GetOrCreateFunctionValue(MethodHandle method, PyObject* object) {
 			return g_py3lm.GetOrCreateFunctionValue(method, object);
 		}
@@ -610,8 +846,14 @@ namespace py3lm {
 			return nullptr;
 		}
 
+		template<typename T>
+		const plg::vector<T>* NativeArrayVector(PyObject* object);
+
 		template<typename T>
 		void* CreateArray(PyObject* pItem) {
+			if (const plg::vector<T>* const vector = NativeArrayVector<T>(pItem)) {
+				return new plg::vector<T>(*vector);
+			}
 			if (auto array = ArrayFromObject<T>(pItem)) {
 				return new plg::vector<T>(std::move(*array));
 			}
@@ -1306,12 +1548,11 @@ namespace py3lm {
 			if (value == char16_t{ 0 }) {
 				return PyUnicode_FromStringAndSize(nullptr, Py_ssize_t{ 0 });
 			}
-			const auto [rc, out] = ConvertUtf16ToUtf8(value);
-			if (rc == -1) {
+			if (0xD800 <= static_cast<uint16_t>(value) && static_cast<uint16_t>(value) < 0xE000) {
 				PyErr_SetString(PyExc_ValueError, "Surrogate pair");
 				return nullptr;
 			}
-			return PyUnicode_FromStringAndSize(out.data(), static_cast<Py_ssize_t>(rc));
+			return PyUnicode_FromOrdinal(static_cast<int>(value));
 		}
 
 		template<>
@@ -1371,12 +1612,12 @@ namespace py3lm {
 
 		template<>
 		PyObject* CreatePyObject(const plg::string& value) {
-			return PyUnicode_FromStringAndSize(value.data(), static_cast<Py_ssize_t>(value.size()));
+			return g_py3lm.CreateStringObject(value);
 		}
 
 		template<>
 		PyObject* CreatePyObject(const std::string_view& value) {
-			return PyUnicode_FromStringAndSize(value.data(), static_cast<Py_ssize_t>(value.size()));
+			return g_py3lm.CreateStringObject(value);
 		}
 
 #if PY3LM_PLATFORM_WINDOWS
@@ -1433,6 +1674,32 @@ namespace py3lm {
 		template<typename T>
 		PyObject* CreatePyObjectList(const plg::vector<T>& arrayArg);
 
+		// Character arrays are marshalled as a single str instead of a list of characters
+		// to callbacks and from native functions marked with plugify.strings.char_arrays
+		PyObject* CreatePyStringFromChars(const plg::vector<char>& arrayArg) {
+			// Bytes which are not valid UTF-8 are kept as lone surrogates and restored on the way back
+			return PyUnicode_DecodeUTF8(arrayArg.data(), static_cast<Py_ssize_t>(arrayArg.size()), "surrogateescape");
+		}
+
+		PyObject* CreatePyStringFromChars(const plg::vector<char16_t>& arrayArg) {
+			const size_t size = arrayArg.size();
+			const auto [maxUnit, surrogates] = ScanUtf16(arrayArg.data(), size);
+			if (surrogates) {
+				int byteOrder = std::endian::native == std::endian::little ? -1 : 1;
+				return PyUnicode_DecodeUTF16(reinterpret_cast<const char*>(arrayArg.data()), static_cast<Py_ssize_t>(size * sizeof(char16_t)), "surrogatepass", &byteOrder);
+			}
+			// Without surrogates units are code points, copy them into str storage of the matching width
+			PyObject* const object = PyUnicode_New(static_cast<Py_ssize_t>(size), maxUnit);
+			if (object) {
+				if (PyUnicode_KIND(object) == PyUnicode_1BYTE_KIND) {
+					NarrowUtf16(arrayArg.data(), size, PyUnicode_1BYTE_DATA(object));
+				} else {
+					std::memcpy(PyUnicode_2BYTE_DATA(object), arrayArg.data(), size * sizeof(char16_t));
+				}
+			}
+			return object;
+		}
+
 		PyObject* CreatePyObject(const plg::any& value) {
 			PyObject* output = nullptr;
 			plg::visit([&output](auto&& val) {
@@ -1450,6 +1717,11 @@ namespace py3lm {
 
 		template<typename T>
 		PyObject* CreatePyObjectList(const plg::vector<T>& arrayArg) {
+			if constexpr (std::is_same_v<T, char> || std::is_same_v<T, char16_t>) {
+				if (currentCallOptions->charArraysAsStr) {
+					return CreatePyStringFromChars(arrayArg);
+				}
+			}
 			const auto size = static_cast<Py_ssize_t>(arrayArg.size());
 			PyObject* const arrayObject = PyList_New(size);
 			if (arrayObject) {
@@ -1465,107 +1737,276 @@ namespace py3lm {
 			return arrayObject;
 		}
 
+		// Buffer format of element scalars, vectors and matrices are exposed as extra dimensions of float
 		template<typename T>
-		PyObject* CreatePyEnumObject(EnumHandle enumerator, const T& value) {
-			return g_py3lm.GetEnumObject(enumerator, static_cast<int64_t>(value));
+		constexpr const char* BufferFormat() {
+			if constexpr (std::is_same_v<T, char>) {
+				return "c";
+			} else if constexpr (std::is_same_v<T, int8_t>) {
+				return "b";
+			} else if constexpr (std::is_same_v<T, int16_t>) {
+				return "h";
+			} else if constexpr (std::is_same_v<T, int32_t>) {
+				return "i";
+			} else if constexpr (std::is_same_v<T, int64_t>) {
+				return "q";
+			} else if constexpr (std::is_same_v<T, uint8_t>) {
+				return "B";
+			} else if constexpr (std::is_same_v<T, char16_t> || std::is_same_v<T, uint16_t>) {
+				return "H";
+			} else if constexpr (std::is_same_v<T, uint32_t>) {
+				return "I";
+			} else if constexpr (std::is_same_v<T, uint64_t>) {
+				return "Q";
+			} else if constexpr (std::is_same_v<T, void*>) {
+				return "P";
+			} else if constexpr (std::is_same_v<T, double>) {
+				return "d";
+			} else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, plg::vec2> || std::is_same_v<T, plg::vec3> ||
+								 std::is_same_v<T, plg::vec4> || std::is_same_v<T, plg::mat4x4>) {
+				return "f";
+			} else {
+				return nullptr;
+			}
 		}
 
 		template<typename T>
-		PyObject* CreatePyEnumObjectList(EnumHandle enumerator, const plg::vector<T>& arrayArg) {
-			const auto size = static_cast<Py_ssize_t>(arrayArg.size());
-			PyObject* const arrayObject = PyList_New(size);
-			if (arrayObject) {
-				for (Py_ssize_t i = 0; i < size; ++i) {
-					PyObject* const valueObject = CreatePyEnumObject(enumerator, arrayArg[i]);
-					if (!valueObject) {
-						Py_DECREF(arrayObject);
-						return nullptr;
-					}
-					PyList_SET_ITEM(arrayObject, i, valueObject);
-				}
+		constexpr std::array<Py_ssize_t, 2> BufferShape() {
+			if constexpr (std::is_same_v<T, plg::vec2>) {
+				return { 2, 0 };
+			} else if constexpr (std::is_same_v<T, plg::vec3>) {
+				return { 3, 0 };
+			} else if constexpr (std::is_same_v<T, plg::vec4>) {
+				return { 4, 0 };
+			} else if constexpr (std::is_same_v<T, plg::mat4x4>) {
+				return { 4, 4 };
+			} else {
+				return { 0, 0 };
 			}
-			return arrayObject;
 		}
 
-		PyObject* ParamToEnumObject(PropertyHandle paramType, const JitCallback::Parameters* params, size_t index) {
-			auto enumerator = paramType.GetEnum();
-			switch (paramType.GetType()) {
-			case ValueType::Int8:
-				return CreatePyEnumObject(enumerator, params->GetArgument<int8_t>(index));
-			case ValueType::Int16:
-				return CreatePyEnumObject(enumerator, params->GetArgument<int16_t>(index));
-			case ValueType::Int32:
-				return CreatePyEnumObject(enumerator, params->GetArgument<int32_t>(index));
-			case ValueType::Int64:
-				return CreatePyEnumObject(enumerator, params->GetArgument<int64_t>(index));
-			case ValueType::UInt8:
-				return CreatePyEnumObject(enumerator, params->GetArgument<uint8_t>(index));
-			case ValueType::UInt16:
-				return CreatePyEnumObject(enumerator, params->GetArgument<uint16_t>(index));
-			case ValueType::UInt32:
-				return CreatePyEnumObject(enumerator, params->GetArgument<uint32_t>(index));
-			case ValueType::UInt64:
-				return CreatePyEnumObject(enumerator, params->GetArgument<uint64_t>(index));
-			case ValueType::ArrayInt8:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<int8_t>*>(index)));
-			case ValueType::ArrayInt16:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<int16_t>*>(index)));
-			case ValueType::ArrayInt32:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<int32_t>*>(index)));
-			case ValueType::ArrayInt64:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<int64_t>*>(index)));
-			case ValueType::ArrayUInt8:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<uint8_t>*>(index)));
-			case ValueType::ArrayUInt16:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<uint16_t>*>(index)));
-			case ValueType::ArrayUInt32:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<uint32_t>*>(index)));
-			case ValueType::ArrayUInt64:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<uint64_t>*>(index)));
-			default: {
-				const std::string error(std::format(LOG_PREFIX "ParamToEnumObject unsupported enum type {:#x}", static_cast<uint8_t>(paramType.GetType())));
-				g_py3lm.LogFatal(error);
-				std::terminate();
+		template<typename T>
+		const NativeArrayOps* GetNativeArrayOps() {
+			constexpr const char* format = BufferFormat<T>();
+			constexpr auto shape = BufferShape<T>();
+			constexpr Py_ssize_t scalars = std::max<Py_ssize_t>(shape[0], 1) * std::max<Py_ssize_t>(shape[1], 1);
+			static const NativeArrayOps ops = {
+				[](const void* data, Py_ssize_t index) -> PyObject* {
+					return CreatePyObject((*static_cast<const plg::vector<T>*>(data))[static_cast<size_t>(index)]);
+				},
+				[](const void* data) -> void* {
+					return new plg::vector<T>(*static_cast<const plg::vector<T>*>(data));
+				},
+				[](void* data) {
+					delete static_cast<plg::vector<T>*>(data);
+				},
+				format ? +[](const void* data) -> const void* {
+					return static_cast<const plg::vector<T>*>(data)->data();
+				} : nullptr,
+				format,
+				static_cast<Py_ssize_t>(sizeof(T)) / scalars,
+				{ shape[0], shape[1] }
+			};
+			return &ops;
+		}
+
+		// Vector of a native array with matching element type, which can be passed to native code as is
+		template<typename T>
+		const plg::vector<T>* NativeArrayVector(PyObject* object) {
+			if (!IsNativeArray(object)) {
 				return nullptr;
 			}
-			}
+			const auto* const array = reinterpret_cast<const NativeArrayObject*>(object);
+			return array->ops == GetNativeArrayOps<T>() ? static_cast<const plg::vector<T>*>(array->data) : nullptr;
+		}
+
+		template<typename T>
+		const NativeRefOps* GetNativeRefOps() {
+			static const NativeRefOps ops = {
+				[](const void* data) -> PyObject* {
+					return CreatePyObject(*static_cast<const T*>(data));
+				},
+				[](void* data, PyObject* value) -> bool {
+					if (auto result = ValueFromObject<T>(value)) {
+						*static_cast<T*>(data) = std::move(*result);
+						return true;
+					}
+					return false;
+				},
+				nullptr, nullptr, nullptr
+			};
+			return &ops;
+		}
+
+		template<typename T>
+		const NativeRefOps* GetNativeVectorRefOps() {
+			static const NativeRefOps ops = {
+				[](const void* data) -> PyObject* {
+					return CreatePyObjectList(*static_cast<const plg::vector<T>*>(data));
+				},
+				[](void* data, PyObject* value) -> bool {
+					if (auto result = ArrayFromObject<T>(value)) {
+						*static_cast<plg::vector<T>*>(data) = std::move(*result);
+						return true;
+					}
+					return false;
+				},
+				[](const void* data) -> Py_ssize_t {
+					return static_cast<Py_ssize_t>(static_cast<const plg::vector<T>*>(data)->size());
+				},
+				[](const void* data, Py_ssize_t index) -> PyObject* {
+					return CreatePyObject((*static_cast<const plg::vector<T>*>(data))[static_cast<size_t>(index)]);
+				},
+				[](void* data, Py_ssize_t index, PyObject* value) -> bool {
+					if (auto result = ValueFromObject<T>(value)) {
+						(*static_cast<plg::vector<T>*>(data))[static_cast<size_t>(index)] = std::move(*result);
+						return true;
+					}
+					return false;
+				}
+			};
+			return &ops;
+		}
+
+		template<typename T>
+		constexpr bool IsLazyArrayElement = std::is_same_v<T, plg::string> || std::is_same_v<T, plg::any> || std::is_same_v<T, plg::vec2> ||
+											std::is_same_v<T, plg::vec3> || std::is_same_v<T, plg::vec4> || std::is_same_v<T, plg::mat4x4>;
+
+		// Large arrays are passed as plugify._core.NativeArray to callbacks and from native functions with lazy arrays.
+		// Borrowed vector stays with the native caller and is detached when the call returns.
+		template<typename T>
+		PyObject* CreatePyObjectSequence(const plg::vector<T>& arrayArg) {
+			if (!UseLazyArray(arrayArg.size())) {
+				return CreatePyObjectList(arrayArg);
+			}
+			PyObject* const array = CreateNativeArray(const_cast<plg::vector<T>*>(&arrayArg), static_cast<Py_ssize_t>(arrayArg.size()), GetNativeArrayOps<T>(), false);
+			if (array) {
+				TrackBorrowedObject(array);
+			}
+			return array;
+		}
+
+		// Returned vector is moved into the array in native returns mode, or when it is lazy
+		template<typename T>
+		PyObject* CreatePyObjectSequence(plg::vector<T>&& arrayArg) {
+			if (!currentCallOptions->nativeReturns && !(IsLazyArrayElement<T> && UseLazyArray(arrayArg.size()))) {
+				return CreatePyObjectList(arrayArg);
+			}
+			const auto size = static_cast<Py_ssize_t>(arrayArg.size());
+			return CreateNativeArray(new plg::vector<T>(std::move(arrayArg)), size, GetNativeArrayOps<T>(), true);
+		}
+
+		template<typename T>
+		PyObject* CreatePyEnumObject(const PythonEnumData& data, const T& value) {
+			PyObject* const object = data.members.Get(static_cast<int64_t>(value));
+			Py_INCREF(object);
+			return object;
+		}
+
+		template<typename T>
+		PyObject* CreatePyEnumObjectList(const PythonEnumData& data, const plg::vector<T>& arrayArg) {
+			const auto size = static_cast<Py_ssize_t>(arrayArg.size());
+			PyObject* const arrayObject = PyList_New(size);
+			if (arrayObject) {
+				for (Py_ssize_t i = 0; i < size; ++i) {
+					PyObject* const valueObject = CreatePyEnumObject(data, arrayArg[i]);
+					if (!valueObject) {
+						Py_DECREF(arrayObject);
+						return nullptr;
+					}
+					PyList_SET_ITEM(arrayObject, i, valueObject);
+				}
+			}
+			return arrayObject;
+		}
+
+		PyObject* ParamToEnumObject(PropertyHandle paramType, const JitCallback::Parameters* params, size_t index) {
+			// Resolve member table once for the whole value or array
+			const PythonEnumData* const data = g_py3lm.ResolveEnum(paramType.GetEnum());
+			if (!data) {
+				return nullptr;
+			}
+			switch (paramType.GetType()) {
+			case ValueType::Int8:
+				return CreatePyEnumObject(*data, params->GetArgument<int8_t>(index));
+			case ValueType::Int16:
+				return CreatePyEnumObject(*data, params->GetArgument<int16_t>(index));
+			case ValueType::Int32:
+				return CreatePyEnumObject(*data, params->GetArgument<int32_t>(index));
+			case ValueType::Int64:
+				return CreatePyEnumObject(*data, params->GetArgument<int64_t>(index));
+			case ValueType::UInt8:
+				return CreatePyEnumObject(*data, params->GetArgument<uint8_t>(index));
+			case ValueType::UInt16:
+				return CreatePyEnumObject(*data, params->GetArgument<uint16_t>(index));
+			case ValueType::UInt32:
+				return CreatePyEnumObject(*data, params->GetArgument<uint32_t>(index));
+			case ValueType::UInt64:
+				return CreatePyEnumObject(*data, params->GetArgument<uint64_t>(index));
+			case ValueType::ArrayInt8:
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<int8_t>*>(index)));
+			case ValueType::ArrayInt16:
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<int16_t>*>(index)));
+			case ValueType::ArrayInt32:
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<int32_t>*>(index)));
+			case ValueType::ArrayInt64:
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<int64_t>*>(index)));
+			case ValueType::ArrayUInt8:
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<uint8_t>*>(index)));
+			case ValueType::ArrayUInt16:
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<uint16_t>*>(index)));
+			case ValueType::ArrayUInt32:
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<uint32_t>*>(index)));
+			case ValueType::ArrayUInt64:
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<uint64_t>*>(index)));
+			default: {
+				const std::string error(std::format(LOG_PREFIX "ParamToEnumObject unsupported enum type {:#x}", static_cast<uint8_t>(paramType.GetType())));
+				g_py3lm.LogFatal(error);
+				std::terminate();
+				return nullptr;
+			}
+			}
 		}
 
 		PyObject* ParamRefToEnumObject(PropertyHandle paramType, const JitCallback::Parameters* params, size_t index) {
-			auto enumerator = paramType.GetEnum();
+			// Resolve member table once for the whole value or array
+			const PythonEnumData* const data = g_py3lm.ResolveEnum(paramType.GetEnum());
+			if (!data) {
+				return nullptr;
+			}
 			switch (paramType.GetType()) {
 			case ValueType::Int8:
-				return CreatePyEnumObject(enumerator, *(params->GetArgument<int8_t*>(index)));
+				return CreatePyEnumObject(*data, *(params->GetArgument<int8_t*>(index)));
 			case ValueType::Int16:
-				return CreatePyEnumObject(enumerator, *(params->GetArgument<int16_t*>(index)));
+				return CreatePyEnumObject(*data, *(params->GetArgument<int16_t*>(index)));
 			case ValueType::Int32:
-				return CreatePyEnumObject(enumerator, *(params->GetArgument<int32_t*>(index)));
+				return CreatePyEnumObject(*data, *(params->GetArgument<int32_t*>(index)));
 			case ValueType::Int64:
-				return CreatePyEnumObject(enumerator, *(params->GetArgument<int64_t*>(index)));
+				return CreatePyEnumObject(*data, *(params->GetArgument<int64_t*>(index)));
 			case ValueType::UInt8:
-				return CreatePyEnumObject(enumerator, *(params->GetArgument<uint8_t*>(index)));
+				return CreatePyEnumObject(*data, *(params->GetArgument<uint8_t*>(index)));
 			case ValueType::UInt16:
-				return CreatePyEnumObject(enumerator, *(params->GetArgument<uint16_t*>(index)));
+				return CreatePyEnumObject(*data, *(params->GetArgument<uint16_t*>(index)));
 			case ValueType::UInt32:
-				return CreatePyEnumObject(enumerator, *(params->GetArgument<uint32_t*>(index)));
+				return CreatePyEnumObject(*data, *(params->GetArgument<uint32_t*>(index)));
 			case ValueType::UInt64:
-				return CreatePyEnumObject(enumerator, *(params->GetArgument<uint64_t*>(index)));
+				return CreatePyEnumObject(*data, *(params->GetArgument<uint64_t*>(index)));
 			case ValueType::ArrayInt8:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<int8_t>*>(index)));
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<int8_t>*>(index)));
 			case ValueType::ArrayInt16:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<int16_t>*>(index)));
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<int16_t>*>(index)));
 			case ValueType::ArrayInt32:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<int32_t>*>(index)));
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<int32_t>*>(index)));
 			case ValueType::ArrayInt64:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<int64_t>*>(index)));
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<int64_t>*>(index)));
 			case ValueType::ArrayUInt8:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<uint8_t>*>(index)));
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<uint8_t>*>(index)));
 			case ValueType::ArrayUInt16:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<uint16_t>*>(index)));
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<uint16_t>*>(index)));
 			case ValueType::ArrayUInt32:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<uint32_t>*>(index)));
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<uint32_t>*>(index)));
 			case ValueType::ArrayUInt64:
-				return CreatePyEnumObjectList(enumerator, *(params->GetArgument<const plg::vector<uint64_t>*>(index)));
+				return CreatePyEnumObjectList(*data, *(params->GetArgument<const plg::vector<uint64_t>*>(index)));
 			default: {
 				const std::string error(std::format(LOG_PREFIX "ParamRefToEnumObject unsupported enum type {:#x}", static_cast<uint8_t>(paramType.GetType())));
 				g_py3lm.LogFatal(error);
@@ -1640,17 +2081,17 @@ namespace py3lm {
 			case ValueType::ArrayDouble:
 				return CreatePyObjectList(*(params->GetArgument<const plg::vector<double>*>(index)));
 			case ValueType::ArrayString:
-				return CreatePyObjectList(*(params->GetArgument<const plg::vector<plg::string>*>(index)));
+				return CreatePyObjectSequence(*(params->GetArgument<const plg::vector<plg::string>*>(index)));
 			case ValueType::ArrayAny:
-				return CreatePyObjectList(*(params->GetArgument<const plg::vector<plg::any>*>(index)));
+				return CreatePyObjectSequence(*(params->GetArgument<const plg::vector<plg::any>*>(index)));
 			case ValueType::ArrayVector2:
-				return CreatePyObjectList(*(params->GetArgument<const plg::vector<plg::vec2>*>(index)));
+				return CreatePyObjectSequence(*(params->GetArgument<const plg::vector<plg::vec2>*>(index)));
 			case ValueType::ArrayVector3:
-				return CreatePyObjectList(*(params->GetArgument<const plg::vector<plg::vec3>*>(index)));
+				return CreatePyObjectSequence(*(params->GetArgument<const plg::vector<plg::vec3>*>(index)));
 			case ValueType::ArrayVector4:
-				return CreatePyObjectList(*(params->GetArgument<const plg::vector<plg::vec4>*>(index)));
+				return CreatePyObjectSequence(*(params->GetArgument<const plg::vector<plg::vec4>*>(index)));
 			case ValueType::ArrayMatrix4x4:
-				return CreatePyObjectList(*(params->GetArgument<const plg::vector<plg::mat4x4>*>(index)));
+				return CreatePyObjectSequence(*(params->GetArgument<const plg::vector<plg::mat4x4>*>(index)));
 			case ValueType::Vector2:
 				return CreatePyObject(*(params->GetArgument<plg::vec2*>(index)));
 			case ValueType::Vector3:
@@ -1759,6 +2200,116 @@ namespace py3lm {
 			}
 		}
 
+		// Refs write straight into native storage of the caller and are detached when the callback returns
+		template<typename T>
+		PyObject* CreateRefView(T* value) {
+			PyObject* const ref = CreateNativeRef(value, GetNativeRefOps<T>());
+			if (ref) {
+				TrackBorrowedObject(ref);
+			}
+			return ref;
+		}
+
+		template<typename T>
+		PyObject* CreateRefView(plg::vector<T>* value) {
+			PyObject* const ref = CreateNativeRef(value, GetNativeVectorRefOps<T>());
+			if (ref) {
+				TrackBorrowedObject(ref);
+			}
+			return ref;
+		}
+
+		PyObject* ParamRefToView(PropertyHandle paramType, const JitCallback::Parameters* params, size_t index) {
+			switch (paramType.GetType()) {
+			case ValueType::Bool:
+				return CreateRefView(params->GetArgument<bool*>(index));
+			case ValueType::Char8:
+				return CreateRefView(params->GetArgument<char*>(index));
+			case ValueType::Char16:
+				return CreateRefView(params->GetArgument<char16_t*>(index));
+			case ValueType::Int8:
+				return CreateRefView(params->GetArgument<int8_t*>(index));
+			case ValueType::Int16:
+				return CreateRefView(params->GetArgument<int16_t*>(index));
+			case ValueType::Int32:
+				return CreateRefView(params->GetArgument<int32_t*>(index));
+			case ValueType::Int64:
+				return CreateRefView(params->GetArgument<int64_t*>(index));
+			case ValueType::UInt8:
+				return CreateRefView(params->GetArgument<uint8_t*>(index));
+			case ValueType::UInt16:
+				return CreateRefView(params->GetArgument<uint16_t*>(index));
+			case ValueType::UInt32:
+				return CreateRefView(params->GetArgument<uint32_t*>(index));
+			case ValueType::UInt64:
+				return CreateRefView(params->GetArgument<uint64_t*>(index));
+			case ValueType::Pointer:
+				return CreateRefView(params->GetArgument<void**>(index));
+			case ValueType::Float:
+				return CreateRefView(params->GetArgument<float*>(index));
+			case ValueType::Double:
+				return CreateRefView(params->GetArgument<double*>(index));
+			case ValueType::String:
+				return CreateRefView(params->GetArgument<plg::string*>(index));
+			case ValueType::Any:
+				return CreateRefView(params->GetArgument<plg::any*>(index));
+			case ValueType::ArrayBool:
+				return CreateRefView(params->GetArgument<plg::vector<bool>*>(index));
+			case ValueType::ArrayChar8:
+				return CreateRefView(params->GetArgument<plg::vector<char>*>(index));
+			case ValueType::ArrayChar16:
+				return CreateRefView(params->GetArgument<plg::vector<char16_t>*>(index));
+			case ValueType::ArrayInt8:
+				return CreateRefView(params->GetArgument<plg::vector<int8_t>*>(index));
+			case ValueType::ArrayInt16:
+				return CreateRefView(params->GetArgument<plg::vector<int16_t>*>(index));
+			case ValueType::ArrayInt32:
+				return CreateRefView(params->GetArgument<plg::vector<int32_t>*>(index));
+			case ValueType::ArrayInt64:
+				return CreateRefView(params->GetArgument<plg::vector<int64_t>*>(index));
+			case ValueType::ArrayUInt8:
+				return CreateRefView(params->GetArgument<plg::vector<uint8_t>*>(index));
+			case ValueType::ArrayUInt16:
+				return CreateRefView(params->GetArgument<plg::vector<uint16_t>*>(index));
+			case ValueType::ArrayUInt32:
+				return CreateRefView(params->GetArgument<plg::vector<uint32_t>*>(index));
+			case ValueType::ArrayUInt64:
+				return CreateRefView(params->GetArgument<plg::vector<uint64_t>*>(index));
+			case ValueType::ArrayPointer:
+				return CreateRefView(params->GetArgument<plg::vector<void*>*>(index));
+			case ValueType::ArrayFloat:
+				return CreateRefView(params->GetArgument<plg::vector<float>*>(index));
+			case ValueType::ArrayDouble:
+				return CreateRefView(params->GetArgument<plg::vector<double>*>(index));
+			case ValueType::ArrayString:
+				return CreateRefView(params->GetArgument<plg::vector<plg::string>*>(index));
+			case ValueType::ArrayAny:
+				return CreateRefView(params->GetArgument<plg::vector<plg::any>*>(index));
+			case ValueType::ArrayVector2:
+				return CreateRefView(params->GetArgument<plg::vector<plg::vec2>*>(index));
+			case ValueType::ArrayVector3:
+				return CreateRefView(params->GetArgument<plg::vector<plg::vec3>*>(index));
+			case ValueType::ArrayVector4:
+				return CreateRefView(params->GetArgument<plg::vector<plg::vec4>*>(index));
+			case ValueType::ArrayMatrix4x4:
+				return CreateRefView(params->GetArgument<plg::vector<plg::mat4x4>*>(index));
+			case ValueType::Vector2:
+				return CreateRefView(params->GetArgument<plg::vec2*>(index));
+			case ValueType::Vector3:
+				return CreateRefView(params->GetArgument<plg::vec3*>(index));
+			case ValueType::Vector4:
+				return CreateRefView(params->GetArgument<plg::vec4*>(index));
+			case ValueType::Matrix4x4:
+				return CreateRefView(params->GetArgument<plg::mat4x4*>(index));
+			default: {
+				const std::string error(std::format(LOG_PREFIX "ParamRefToView unsupported type {:#x}", static_cast<uint8_t>(paramType.GetType())));
+				g_py3lm.LogFatal(error);
+				std::terminate();
+				return nullptr;
+			}
+			}
+		}
+
 		struct GILLock {
 			GILLock() {
 				_state = PyGILState_Ensure();
@@ -1772,10 +2323,74 @@ namespace py3lm {
 			PyGILState_STATE _state;
 		};
 
+		// Native arrays and refs borrowed from callback parameters are detached when the callback returns
+		struct BorrowedObjectsScope {
+			BorrowedObjectsScope() : mark(borrowedObjects.size()) {}
+			~BorrowedObjectsScope() {
+				while (borrowedObjects.size() > mark) {
+					PyObject* const object = borrowedObjects.back();
+					borrowedObjects.pop_back();
+					if (IsNativeArray(object)) {
+						DetachNativeArray(object);
+					} else {
+						DetachNativeRef(object);
+					}
+					Py_DECREF(object);
+				}
+			}
+			BorrowedObjectsScope(const BorrowedObjectsScope&) = delete;
+			BorrowedObjectsScope& operator=(const BorrowedObjectsScope&) = delete;
+
+			size_t mark;
+		};
+
+		// Code running in the scope belongs to the plugin, tasks it creates are cancelled when the plugin ends
+		struct PluginContextScope {
+			explicit PluginContextScope(PyObject* plugin) {
+				if (plugin && g_py3lm.CurrentPlugin() != plugin) {
+					token = PyContextVar_Set(g_py3lm.GetPluginContextVar(), plugin);
+					if (!token) {
+						g_py3lm.LogError();
+					}
+				}
+			}
+			~PluginContextScope() {
+				if (token) {
+					if (PyContextVar_Reset(g_py3lm.GetPluginContextVar(), token) != 0) {
+						g_py3lm.LogError();
+					}
+					Py_DECREF(token);
+				}
+			}
+			PluginContextScope(const PluginContextScope&) = delete;
+			PluginContextScope& operator=(const PluginContextScope&) = delete;
+
+			PyObject* token = nullptr;
+		};
+
+		// With RefViews reference parameters are passed as refs writing through to native memory,
+		// otherwise their new values are returned in a tuple after the return value
+		template<bool RefViews, bool HasOptions>
 		void InternalCall(MethodHandle method, MemAddr data, const JitCallback::Parameters* params, const size_t, const JitCallback::Return* ret) {
 			GILLock lock{};
-
-			PyObject* const func = data.RCast<PyObject*>();
+			BorrowedObjectsScope borrowedObjects{};
+
+			PyObject* func;
+			const CallOptions* options;
+			PyObject* plugin;
+			if constexpr (HasOptions) {
+				const auto* const callback = data.RCast<const CallbackOptions*>();
+				func = callback->function;
+				options = &callback->options;
+				plugin = callback->plugin;
+			} else {
+				func = data.RCast<PyObject*>();
+				options = &DefaultCallOptions;
+				plugin = nullptr;
+			}
+			// Options of a native call running this callback don't apply to it
+			CallOptionsScope optionsScope(*options);
+			PluginContextScope pluginContext(plugin);
 
 			enum class ParamProcess {
 				NoError,
@@ -1802,10 +2417,10 @@ namespace py3lm {
 							++refParamsCount;
 						}
 						using ParamConvertionFunc = PyObject* (*)(PropertyHandle, const JitCallback::Parameters*, size_t);
-						ParamConvertionFunc const convertFunc = paramType.GetEnum() ?
+						ParamConvertionFunc const convertFunc = RefViews && paramType.IsReference() ? &ParamRefToView :
+							paramType.GetEnum() ?
 							(paramType.IsReference() ? &ParamRefToEnumObject : &ParamToEnumObject) :
 							(paramType.IsReference() ? &ParamRefToObject : &ParamToObject);
-						convertFunc(paramType, params, index);
 						PyObject* const arg = convertFunc(paramType, params, index);
 						if (!arg) {
 							// convertFunc may set error
@@ -1852,7 +2467,38 @@ namespace py3lm {
 				return;
 			}
 
-			if (refParamsCount != 0) {
+			if (PyCoro_CheckExact(result)) {
+				if (refParamsCount != 0 || retType.GetType() != ValueType::Void) {
+					// Rejected coroutine is closed, so it neither runs later nor warns about never being awaited
+					if (PyObject* const closeResult = PyObject_CallMethod(result, "close", nullptr)) {
+						Py_DECREF(closeResult);
+					} else {
+						g_py3lm.LogError();
+					}
+					Py_DECREF(result);
+
+					PyErr_SetString(PyExc_TypeError, "Coroutine callback can't return values to native caller");
+
+					g_py3lm.LogError();
+
+					SetFallbackReturn(retType.GetType(), ret);
+
+					return;
+				}
+
+				// Async callback runs on the event loop driven by host update
+				PyObject* const task = g_py3lm.CreateTask(result);
+				Py_DECREF(result);
+				if (!task) {
+					g_py3lm.LogError();
+				} else {
+					Py_DECREF(task);
+				}
+
+				return;
+			}
+
+			if (!RefViews && refParamsCount != 0) {
 				if (!PyTuple_CheckExact(result)) {
 					SetTypeError("Expected tuple as return value", result);
 
@@ -1895,7 +2541,7 @@ namespace py3lm {
 				}
 			}
 
-			PyObject* const returnObject = refParamsCount != 0 ? PyTuple_GET_ITEM(result, Py_ssize_t{ 0 }) : result;
+			PyObject* const returnObject = !RefViews && refParamsCount != 0 ? PyTuple_GET_ITEM(result, Py_ssize_t{ 0 }) : result;
 
 			if (!SetReturn(returnObject, retType, ret)) {
 				if (PyErr_Occurred()) {
@@ -1908,13 +2554,69 @@ namespace py3lm {
 			Py_DECREF(result);
 		}
 
-		std::pair<bool, JitCallback> CreateInternalCall(const std::shared_ptr<asmjit::JitRuntime>& jitRuntime, MethodHandle method, PyObject* func) {
+		// Set by plugify.refs.views decorator, checked once when callback is created
+		bool UsesRefViews(PyObject* func) {
+			PyObject* const flag = PyObject_GetAttrString(func, "__plugify_ref_views__");
+			if (!flag) {
+				PyErr_Clear();
+				return false;
+			}
+			const int result = PyObject_IsTrue(flag);
+			Py_DECREF(flag);
+			if (result < 0) {
+				PyErr_Clear();
+			}
+			return result > 0;
+		}
+
+		// Set by plugify.arrays.lazy decorator, 0 when callback gets lists
+		size_t LazyArrayMinSize(PyObject* func) {
+			PyObject* const minSize = PyObject_GetAttrString(func, "__plugify_lazy_arrays__");
+			if (!minSize) {
+				PyErr_Clear();
+				return 0;
+			}
+			const size_t result = PyLong_Check(minSize) ? PyLong_AsSize_t(minSize) : 0;
+			Py_DECREF(minSize);
+			if (result == static_cast<size_t>(-1)) {
+				PyErr_Clear();
+				return 0;
+			}
+			return result;
+		}
+
+		// Set by plugify.strings.char_arrays decorator
+		bool UsesCharArraysAsStr(PyObject* func) {
+			PyObject* const flag = PyObject_GetAttrString(func, "__plugify_char_arrays__");
+			if (!flag) {
+				PyErr_Clear();
+				return false;
+			}
+			const int result = PyObject_IsTrue(flag);
+			Py_DECREF(flag);
+			if (result < 0) {
+				PyErr_Clear();
+			}
+			return result > 0;
+		}
+
+		std::pair<bool, JitCallback> CreateInternalCall(const std::shared_ptr<asmjit::JitRuntime>& jitRuntime, MethodHandle method, PyObject* func, PyObject* plugin) {
 			JitCallback callback(jitRuntime);
-			void* const methodAddr = callback.GetJitFunc(method, &InternalCall, func);
+			const bool refViews = UsesRefViews(func);
+			CallOptions options;
+			options.lazyArrayMinSize = LazyArrayMinSize(func);
+			options.charArraysAsStr = UsesCharArraysAsStr(func);
+			void* methodAddr;
+			if (options.lazyArrayMinSize != 0 || options.charArraysAsStr || plugin) {
+				CallbackOptions* const data = g_py3lm.AddCallbackOptions(func, options, plugin);
+				methodAddr = callback.GetJitFunc(method, refViews ? &InternalCall<true, true> : &InternalCall<false, true>, data);
+			} else {
+				methodAddr = callback.GetJitFunc(method, refViews ? &InternalCall<true, false> : &InternalCall<false, false>, func);
+			}
 			return { methodAddr != nullptr, std::move(callback) };
 		}
 
-		MethodExportResult GenerateMethodExport(MethodHandle method, const std::shared_ptr<asmjit::JitRuntime>& jitRuntime, PyObject* pluginDict, PyObject* pluginInstance) {
+		MethodExportResult GenerateMethodExport(MethodHandle method, const std::shared_ptr<asmjit::JitRuntime>& jitRuntime, PyObject* pluginDict, PyObject* pluginInstance, PyObject* plugin) {
 			PyObject* func{};
 
 			std::string className, methodName;
@@ -1960,7 +2662,7 @@ namespace py3lm {
 				func = bind;
 			}
 
-			auto [result, callback] = CreateInternalCall(jitRuntime, method, func);
+			auto [result, callback] = CreateInternalCall(jitRuntime, method, func, plugin);
 
 			if (!result) {
 				Py_DECREF(func);
@@ -1973,10 +2675,29 @@ namespace py3lm {
 		struct ArgsScope {
 			JitCall::Parameters params;
 			std::vector<std::pair<void*, ValueType>> storage; // used to store array temp memory
+			std::vector<void*> refs; // values of reference parameters in order, written back after the call
 
 			explicit ArgsScope(size_t size) : params(size) {
 				storage.reserve(size);
 			}
+			ArgsScope(const ArgsScope&) = delete;
+			ArgsScope& operator=(const ArgsScope&) = delete;
+
+			// First string parameters live in the scope itself instead of separate heap allocations
+			static constexpr size_t InlineStrings = 4;
+			alignas(plg::string) std::byte inlineStrings[InlineStrings][sizeof(plg::string)];
+			size_t inlineStringCount = 0;
+
+			plg::string* EmplaceString(std::string_view str) {
+				if (inlineStringCount < InlineStrings) {
+					return new (inlineStrings[inlineStringCount++]) plg::string(str);
+				}
+				return new plg::string(str);
+			}
+
+			bool IsInlineString(const void* ptr) const {
+				return ptr >= inlineStrings && ptr < inlineStrings + InlineStrings;
+			}
 
 			~ArgsScope() {
 				for (auto& [ptr, type] : storage) {
@@ -2038,7 +2759,11 @@ namespace py3lm {
 						break;
 					}
 					case ValueType::String: {
-						delete static_cast<plg::string*>(ptr);
+						if (IsInlineString(ptr)) {
+							std::destroy_at(static_cast<plg::string*>(ptr));
+						} else {
+							delete static_cast<plg::string*>(ptr);
+						}
 						break;
 					}
 					case ValueType::Any: {
@@ -2297,71 +3022,75 @@ namespace py3lm {
 
 		PyObject* MakeExternalCallWithEnumObject(PropertyHandle retType, JitCall::CallingFunc func, const ArgsScope& a, JitCall::Return& ret) {
 			func(a.params.GetDataPtr(), &ret);
-			auto enumerator = retType.GetEnum();
+			// Resolve member table once for the whole value or array
+			const PythonEnumData* const data = g_py3lm.ResolveEnum(retType.GetEnum());
+			if (!data) {
+				return nullptr;
+			}
 			switch (retType.GetType()) {
 			case ValueType::Int8: {
 				const int8_t val = ret.GetReturn<int8_t>();
-				return CreatePyEnumObject(enumerator, val);
+				return CreatePyEnumObject(*data, val);
 			}
 			case ValueType::Int16: {
 				const int16_t val = ret.GetReturn<int16_t>();
-				return CreatePyEnumObject(enumerator, val);
+				return CreatePyEnumObject(*data, val);
 			}
 			case ValueType::Int32: {
 				const int32_t val = ret.GetReturn<int32_t>();
-				return CreatePyEnumObject(enumerator, val);
+				return CreatePyEnumObject(*data, val);
 			}
 			case ValueType::Int64: {
 				const int64_t val = ret.GetReturn<int64_t>();
-				return CreatePyEnumObject(enumerator, val);
+				return CreatePyEnumObject(*data, val);
 			}
 			case ValueType::UInt8: {
 				const uint8_t val = ret.GetReturn<uint8_t>();
-				return CreatePyEnumObject(enumerator, val);
+				return CreatePyEnumObject(*data, val);
 			}
 			case ValueType::UInt16: {
 				const uint16_t val = ret.GetReturn<uint16_t>();
-				return CreatePyEnumObject(enumerator, val);
+				return CreatePyEnumObject(*data, val);
 			}
 			case ValueType::UInt32: {
 				const uint32_t val = ret.GetReturn<uint32_t>();
-				return CreatePyEnumObject(enumerator, val);
+				return CreatePyEnumObject(*data, val);
 			}
 			case ValueType::UInt64: {
 				const uint64_t val = ret.GetReturn<uint64_t>();
-				return CreatePyEnumObject(enumerator, val);
+				return CreatePyEnumObject(*data, val);
 			}
 			case ValueType::ArrayInt8: {
 				auto* const arr = ret.GetReturn<plg::vector<int8_t>*>();
-				return CreatePyEnumObjectList<int8_t>(enumerator, *arr);
+				return CreatePyEnumObjectList<int8_t>(*data, *arr);
 			}
 			case ValueType::ArrayInt16: {
 				auto* const arr = ret.GetReturn<plg::vector<int16_t>*>();
-				return CreatePyEnumObjectList<int16_t>(enumerator, *arr);
+				return CreatePyEnumObjectList<int16_t>(*data, *arr);
 			}
 			case ValueType::ArrayInt32: {
 				auto* const arr = ret.GetReturn<plg::vector<int32_t>*>();
-				return CreatePyEnumObjectList<int32_t>(enumerator, *arr);
+				return CreatePyEnumObjectList<int32_t>(*data, *arr);
 			}
 			case ValueType::ArrayInt64: {
 				auto* const arr = ret.GetReturn<plg::vector<int64_t>*>();
-				return CreatePyEnumObjectList<int64_t>(enumerator, *arr);
+				return CreatePyEnumObjectList<int64_t>(*data, *arr);
 			}
 			case ValueType::ArrayUInt8: {
 				auto* const arr = ret.GetReturn<plg::vector<uint8_t>*>();
-				return CreatePyEnumObjectList<uint8_t>(enumerator, *arr);
+				return CreatePyEnumObjectList<uint8_t>(*data, *arr);
 			}
 			case ValueType::ArrayUInt16: {
 				auto* const arr = ret.GetReturn<plg::vector<uint16_t>*>();
-				return CreatePyEnumObjectList<uint16_t>(enumerator, *arr);
+				return CreatePyEnumObjectList<uint16_t>(*data, *arr);
 			}
 			case ValueType::ArrayUInt32: {
 				auto* const arr = ret.GetReturn<plg::vector<uint32_t>*>();
-				return CreatePyEnumObjectList<uint32_t>(enumerator, *arr);
+				return CreatePyEnumObjectList<uint32_t>(*data, *arr);
 			}
 			case ValueType::ArrayUInt64: {
 				auto* const arr = ret.GetReturn<plg::vector<uint64_t>*>();
-				return CreatePyEnumObjectList<uint64_t>(enumerator, *arr);
+				return CreatePyEnumObjectList<uint64_t>(*data, *arr);
 			}
 			default: {
 				const std::string error(std::format("MakeExternalCallWithEnumObject unsupported enum type {:#x}", static_cast<uint8_t>(retType.GetType())));
@@ -2447,83 +3176,83 @@ namespace py3lm {
 			}
 			case ValueType::ArrayBool: {
 				auto* const arr = ret.GetReturn<plg::vector<bool>*>();
-				return CreatePyObjectList<bool>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayChar8: {
 				auto* const arr = ret.GetReturn<plg::vector<char>*>();
-				return CreatePyObjectList<char>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayChar16: {
 				auto* const arr = ret.GetReturn<plg::vector<char16_t>*>();
-				return CreatePyObjectList<char16_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayInt8: {
 				auto* const arr = ret.GetReturn<plg::vector<int8_t>*>();
-				return CreatePyObjectList<int8_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayInt16: {
 				auto* const arr = ret.GetReturn<plg::vector<int16_t>*>();
-				return CreatePyObjectList<int16_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayInt32: {
 				auto* const arr = ret.GetReturn<plg::vector<int32_t>*>();
-				return CreatePyObjectList<int32_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayInt64: {
 				auto* const arr = ret.GetReturn<plg::vector<int64_t>*>();
-				return CreatePyObjectList<int64_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayUInt8: {
 				auto* const arr = ret.GetReturn<plg::vector<uint8_t>*>();
-				return CreatePyObjectList<uint8_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayUInt16: {
 				auto* const arr = ret.GetReturn<plg::vector<uint16_t>*>();
-				return CreatePyObjectList<uint16_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayUInt32: {
 				auto* const arr = ret.GetReturn<plg::vector<uint32_t>*>();
-				return CreatePyObjectList<uint32_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayUInt64: {
 				auto* const arr = ret.GetReturn<plg::vector<uint64_t>*>();
-				return CreatePyObjectList<uint64_t>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayPointer: {
 				auto* const arr = ret.GetReturn<plg::vector<void*>*>();
-				return CreatePyObjectList<void*>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayFloat: {
 				auto* const arr = ret.GetReturn<plg::vector<float>*>();
-				return CreatePyObjectList<float>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayDouble: {
 				auto* const arr = ret.GetReturn<plg::vector<double>*>();
-				return CreatePyObjectList<double>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayString: {
 				auto* const arr = ret.GetReturn<plg::vector<plg::string>*>();
-				return CreatePyObjectList<plg::string>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayAny: {
 				auto* const arr = ret.GetReturn<plg::vector<plg::any>*>();
-				return CreatePyObjectList<plg::any>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayVector2: {
 				auto* const arr = ret.GetReturn<plg::vector<plg::vec2>*>();
-				return CreatePyObjectList<plg::vec2>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayVector3: {
 				auto* const arr = ret.GetReturn<plg::vector<plg::vec3>*>();
-				return CreatePyObjectList<plg::vec3>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayVector4: {
 				auto* const arr = ret.GetReturn<plg::vector<plg::vec4>*>();
-				return CreatePyObjectList<plg::vec4>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::ArrayMatrix4x4: {
 				auto* const arr = ret.GetReturn<plg::vector<plg::mat4x4>*>();
-				return CreatePyObjectList<plg::mat4x4>(*arr);
+				return CreatePyObjectSequence(std::move(*arr));
 			}
 			case ValueType::Vector2: {
 				const plg::vec2 val = ret.GetReturn<plg::vec2>();
@@ -2560,6 +3289,30 @@ namespace py3lm {
 			return nullptr;
 		}
 
+		// String is built straight from UTF-8 buffer which str caches in itself, bytes are taken without decoding
+		void* CreateStringParam(PyObject* pItem, ArgsScope& a) {
+			if (const auto view = StringViewFromObject(pItem)) {
+				return a.EmplaceString(*view);
+			}
+			return nullptr;
+		}
+
+		// Vector of a native array is passed without copy, other objects are converted into a temporary vector
+		template<typename T>
+		bool PushArrayParam(PropertyHandle paramType, PyObject* pItem, ArgsScope& a) {
+			if (const plg::vector<T>* const vector = NativeArrayVector<T>(pItem)) {
+				a.params.AddArgument(vector);
+				return true;
+			}
+			void* const value = CreateArray<T>(pItem);
+			if (!value) {
+				return false;
+			}
+			a.storage.emplace_back(value, paramType.GetType());
+			a.params.AddArgument(value);
+			return true;
+		}
+
 		bool PushObjectAsParam(PropertyHandle paramType, PyObject* pItem, ArgsScope& a) {
 			const auto PushValParam = [&a](auto&& value) {
 				if (!value) {
@@ -2606,51 +3359,51 @@ namespace py3lm {
 				case ValueType::Double:
 					return PushValParam(ValueFromObject<double>(pItem));
 				case ValueType::String:
-					return PushRefParam(CreateValue<plg::string>(pItem));
+					return PushRefParam(CreateStringParam(pItem, a));
 				case ValueType::Any:
 					return PushRefParam(CreateValue<plg::any>(pItem));
 				case ValueType::Function:
 					return PushValParam(GetOrCreateFunctionValue(paramType.GetPrototype(), pItem));
 				case ValueType::ArrayBool:
-					return PushRefParam(CreateArray<bool>(pItem));
+					return PushArrayParam<bool>(paramType, pItem, a);
 				case ValueType::ArrayChar8:
-					return PushRefParam(CreateArray<char>(pItem));
+					return PushArrayParam<char>(paramType, pItem, a);
 				case ValueType::ArrayChar16:
-					return PushRefParam(CreateArray<char16_t>(pItem));
+					return PushArrayParam<char16_t>(paramType, pItem, a);
 				case ValueType::ArrayInt8:
-					return PushRefParam(CreateArray<int8_t>(pItem));
+					return PushArrayParam<int8_t>(paramType, pItem, a);
 				case ValueType::ArrayInt16:
-					return PushRefParam(CreateArray<int16_t>(pItem));
+					return PushArrayParam<int16_t>(paramType, pItem, a);
 				case ValueType::ArrayInt32:
-					return PushRefParam(CreateArray<int32_t>(pItem));
+					return PushArrayParam<int32_t>(paramType, pItem, a);
 				case ValueType::ArrayInt64:
-					return PushRefParam(CreateArray<int64_t>(pItem));
+					return PushArrayParam<int64_t>(paramType, pItem, a);
 				case ValueType::ArrayUInt8:
-					return PushRefParam(CreateArray<uint8_t>(pItem));
+					return PushArrayParam<uint8_t>(paramType, pItem, a);
 				case ValueType::ArrayUInt16:
-					return PushRefParam(CreateArray<uint16_t>(pItem));
+					return PushArrayParam<uint16_t>(paramType, pItem, a);
 				case ValueType::ArrayUInt32:
-					return PushRefParam(CreateArray<uint32_t>(pItem));
+					return PushArrayParam<uint32_t>(paramType, pItem, a);
 				case ValueType::ArrayUInt64:
-					return PushRefParam(CreateArray<uint64_t>(pItem));
+					return PushArrayParam<uint64_t>(paramType, pItem, a);
 				case ValueType::ArrayPointer:
-					return PushRefParam(CreateArray<void*>(pItem));
+					return PushArrayParam<void*>(paramType, pItem, a);
 				case ValueType::ArrayFloat:
-					return PushRefParam(CreateArray<float>(pItem));
+					return PushArrayParam<float>(paramType, pItem, a);
 				case ValueType::ArrayDouble:
-					return PushRefParam(CreateArray<double>(pItem));
+					return PushArrayParam<double>(paramType, pItem, a);
 				case ValueType::ArrayString:
-					return PushRefParam(CreateArray<plg::string>(pItem));
+					return PushArrayParam<plg::string>(paramType, pItem, a);
 				case ValueType::ArrayAny:
-					return PushRefParam(CreateArray<plg::any>(pItem));
+					return PushArrayParam<plg::any>(paramType, pItem, a);
 				case ValueType::ArrayVector2:
-					return PushRefParam(CreateArray<plg::vec2>(pItem));
+					return PushArrayParam<plg::vec2>(paramType, pItem, a);
 				case ValueType::ArrayVector3:
-					return PushRefParam(CreateArray<plg::vec3>(pItem));
+					return PushArrayParam<plg::vec3>(paramType, pItem, a);
 				case ValueType::ArrayVector4:
-					return PushRefParam(CreateArray<plg::vec4>(pItem));
+					return PushArrayParam<plg::vec4>(paramType, pItem, a);
 				case ValueType::ArrayMatrix4x4:
-					return PushRefParam(CreateArray<plg::mat4x4>(pItem));
+					return PushArrayParam<plg::mat4x4>(paramType, pItem, a);
 				case ValueType::Vector2:
 					return PushRefParam(CreateValue<plg::vec2>(pItem));
 				case ValueType::Vector3:
@@ -2675,6 +3428,7 @@ namespace py3lm {
 					return false;
 				}
 				a.storage.emplace_back(value, paramType.GetType());
+				a.refs.push_back(value);
 				a.params.AddArgument(value);
 				return true;
 			};
@@ -2709,7 +3463,12 @@ namespace py3lm {
 			case ValueType::Double:
 				return PushRefParam(CreateValue<double>(pItem));
 			case ValueType::String:
-				return PushRefParam(CreateValue<plg::string>(pItem));
+				// New value is returned as str, so bytes would come back with another type
+				if (PyBytes_Check(pItem)) {
+					SetTypeError("Expected str for string reference parameter", pItem);
+					return false;
+				}
+				return PushRefParam(CreateStringParam(pItem, a));
 			case ValueType::Any:
 				return PushRefParam(CreateValue<plg::any>(pItem));
 			case ValueType::ArrayBool:
@@ -2770,41 +3529,45 @@ namespace py3lm {
 			return false;
 		}
 
-		PyObject* StorageValueToEnumObject(PropertyHandle paramType, const ArgsScope& a, size_t index) {
-			auto enumerator = paramType.GetEnum();
+		PyObject* StorageValueToEnumObject(PropertyHandle paramType, const void* value) {
+			// Resolve member table once for the whole value or array
+			const PythonEnumData* const data = g_py3lm.ResolveEnum(paramType.GetEnum());
+			if (!data) {
+				return nullptr;
+			}
 			switch (paramType.GetType()) {
 			case ValueType::Int8:
-				return CreatePyEnumObject(enumerator, *static_cast<int8_t*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObject(*data, *static_cast<const int8_t*>(value));
 			case ValueType::Int16:
-				return CreatePyEnumObject(enumerator, *static_cast<int16_t*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObject(*data, *static_cast<const int16_t*>(value));
 			case ValueType::Int32:
-				return CreatePyEnumObject(enumerator, *static_cast<int32_t*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObject(*data, *static_cast<const int32_t*>(value));
 			case ValueType::Int64:
-				return CreatePyEnumObject(enumerator, *static_cast<int64_t*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObject(*data, *static_cast<const int64_t*>(value));
 			case ValueType::UInt8:
-				return CreatePyEnumObject(enumerator, *static_cast<uint8_t*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObject(*data, *static_cast<const uint8_t*>(value));
 			case ValueType::UInt16:
-				return CreatePyEnumObject(enumerator, *static_cast<uint16_t*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObject(*data, *static_cast<const uint16_t*>(value));
 			case ValueType::UInt32:
-				return CreatePyEnumObject(enumerator, *static_cast<uint32_t*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObject(*data, *static_cast<const uint32_t*>(value));
 			case ValueType::UInt64:
-				return CreatePyEnumObject(enumerator, *static_cast<uint64_t*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObject(*data, *static_cast<const uint64_t*>(value));
 			case ValueType::ArrayInt8:
-				return CreatePyEnumObjectList(enumerator, *static_cast<plg::vector<int8_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObjectList(*data, *static_cast<const plg::vector<int8_t>*>(value));
 			case ValueType::ArrayInt16:
-				return CreatePyEnumObjectList(enumerator, *static_cast<plg::vector<int16_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObjectList(*data, *static_cast<const plg::vector<int16_t>*>(value));
 			case ValueType::ArrayInt32:
-				return CreatePyEnumObjectList(enumerator, *static_cast<plg::vector<int32_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObjectList(*data, *static_cast<const plg::vector<int32_t>*>(value));
 			case ValueType::ArrayInt64:
-				return CreatePyEnumObjectList(enumerator, *static_cast<plg::vector<int64_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObjectList(*data, *static_cast<const plg::vector<int64_t>*>(value));
 			case ValueType::ArrayUInt8:
-				return CreatePyEnumObjectList(enumerator, *static_cast<plg::vector<uint8_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObjectList(*data, *static_cast<const plg::vector<uint8_t>*>(value));
 			case ValueType::ArrayUInt16:
-				return CreatePyEnumObjectList(enumerator, *static_cast<plg::vector<uint16_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObjectList(*data, *static_cast<const plg::vector<uint16_t>*>(value));
 			case ValueType::ArrayUInt32:
-				return CreatePyEnumObjectList(enumerator, *static_cast<plg::vector<uint32_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObjectList(*data, *static_cast<const plg::vector<uint32_t>*>(value));
 			case ValueType::ArrayUInt64:
-				return CreatePyEnumObjectList(enumerator, *static_cast<plg::vector<uint64_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyEnumObjectList(*data, *static_cast<const plg::vector<uint64_t>*>(value));
 			default: {
 				const std::string error(std::format("StorageValueToObject unsupported enum type {:#x}", static_cast<uint8_t>(paramType.GetType())));
 				PyErr_SetString(PyExc_RuntimeError, error.c_str());
@@ -2813,88 +3576,88 @@ namespace py3lm {
 			}
 		}
 
-		PyObject* StorageValueToObject(PropertyHandle paramType, const ArgsScope& a, size_t index) {
+		PyObject* StorageValueToObject(PropertyHandle paramType, const void* value) {
 			switch (paramType.GetType()) {
 			case ValueType::Bool:
-				return CreatePyObject(*static_cast<bool*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const bool*>(value));
 			case ValueType::Char8:
-				return CreatePyObject(*static_cast<char*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const char*>(value));
 			case ValueType::Char16:
-				return CreatePyObject(*static_cast<char16_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const char16_t*>(value));
 			case ValueType::Int8:
-				return CreatePyObject(*static_cast<int8_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const int8_t*>(value));
 			case ValueType::Int16:
-				return CreatePyObject(*static_cast<int16_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const int16_t*>(value));
 			case ValueType::Int32:
-				return CreatePyObject(*static_cast<int32_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const int32_t*>(value));
 			case ValueType::Int64:
-				return CreatePyObject(*static_cast<int64_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const int64_t*>(value));
 			case ValueType::UInt8:
-				return CreatePyObject(*static_cast<uint8_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const uint8_t*>(value));
 			case ValueType::UInt16:
-				return CreatePyObject(*static_cast<uint16_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const uint16_t*>(value));
 			case ValueType::UInt32:
-				return CreatePyObject(*static_cast<uint32_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const uint32_t*>(value));
 			case ValueType::UInt64:
-				return CreatePyObject(*static_cast<uint64_t*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const uint64_t*>(value));
 			case ValueType::Float:
-				return CreatePyObject(*static_cast<float*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const float*>(value));
 			case ValueType::Double:
-				return CreatePyObject(*static_cast<double*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const double*>(value));
 			case ValueType::String:
-				return CreatePyObject(*static_cast<plg::string*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const plg::string*>(value));
 			case ValueType::Any:
-				return CreatePyObject(*static_cast<plg::any*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const plg::any*>(value));
 			case ValueType::Pointer:
-				return CreatePyObject(*static_cast<void**>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<void* const*>(value));
 			case ValueType::ArrayBool:
-				return CreatePyObjectList(*static_cast<plg::vector<bool>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<bool>*>(value));
 			case ValueType::ArrayChar8:
-				return CreatePyObjectList(*static_cast<plg::vector<char>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<char>*>(value));
 			case ValueType::ArrayChar16:
-				return CreatePyObjectList(*static_cast<plg::vector<char16_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<char16_t>*>(value));
 			case ValueType::ArrayInt8:
-				return CreatePyObjectList(*static_cast<plg::vector<int8_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<int8_t>*>(value));
 			case ValueType::ArrayInt16:
-				return CreatePyObjectList(*static_cast<plg::vector<int16_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<int16_t>*>(value));
 			case ValueType::ArrayInt32:
-				return CreatePyObjectList(*static_cast<plg::vector<int32_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<int32_t>*>(value));
 			case ValueType::ArrayInt64:
-				return CreatePyObjectList(*static_cast<plg::vector<int64_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<int64_t>*>(value));
 			case ValueType::ArrayUInt8:
-				return CreatePyObjectList(*static_cast<plg::vector<uint8_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<uint8_t>*>(value));
 			case ValueType::ArrayUInt16:
-				return CreatePyObjectList(*static_cast<plg::vector<uint16_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<uint16_t>*>(value));
 			case ValueType::ArrayUInt32:
-				return CreatePyObjectList(*static_cast<plg::vector<uint32_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<uint32_t>*>(value));
 			case ValueType::ArrayUInt64:
-				return CreatePyObjectList(*static_cast<plg::vector<uint64_t>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<uint64_t>*>(value));
 			case ValueType::ArrayPointer:
-				return CreatePyObjectList(*static_cast<plg::vector<void*>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<void*>*>(value));
 			case ValueType::ArrayFloat:
-				return CreatePyObjectList(*static_cast<plg::vector<float>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<float>*>(value));
 			case ValueType::ArrayDouble:
-				return CreatePyObjectList(*static_cast<plg::vector<double>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<double>*>(value));
 			case ValueType::ArrayString:
-				return CreatePyObjectList(*static_cast<plg::vector<plg::string>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<plg::string>*>(value));
 			case ValueType::ArrayAny:
-				return CreatePyObjectList(*static_cast<plg::vector<plg::any>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<plg::any>*>(value));
 			case ValueType::ArrayVector2:
-				return CreatePyObjectList(*static_cast<plg::vector<plg::vec2>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<plg::vec2>*>(value));
 			case ValueType::ArrayVector3:
-				return CreatePyObjectList(*static_cast<plg::vector<plg::vec3>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<plg::vec3>*>(value));
 			case ValueType::ArrayVector4:
-				return CreatePyObjectList(*static_cast<plg::vector<plg::vec4>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<plg::vec4>*>(value));
 			case ValueType::ArrayMatrix4x4:
-				return CreatePyObjectList(*static_cast<plg::vector<plg::mat4x4>*>(std::get<0>(a.storage[index])));
+				return CreatePyObjectList(*static_cast<const plg::vector<plg::mat4x4>*>(value));
 			case ValueType::Vector2:
-				return CreatePyObject(*static_cast<plg::vec2*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const plg::vec2*>(value));
 			case ValueType::Vector3:
-				return CreatePyObject(*static_cast<plg::vec3*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const plg::vec3*>(value));
 			case ValueType::Vector4:
-				return CreatePyObject(*static_cast<plg::vec4*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const plg::vec4*>(value));
 			case ValueType::Matrix4x4:
-				return CreatePyObject(*static_cast<plg::mat4x4*>(std::get<0>(a.storage[index])));
+				return CreatePyObject(*static_cast<const plg::mat4x4*>(value));
 			default: {
 				const std::string error(std::format("StorageValueToObject unsupported type {:#x}", static_cast<uint8_t>(paramType.GetType())));
 				PyErr_SetString(PyExc_RuntimeError, error.c_str());
@@ -2903,32 +3666,447 @@ namespace py3lm {
 			}
 		}
 
-		// PyObject* (MethodPyCall*)(PyObject* self, PyObject* args)
-		void ExternalCallNoArgs(MethodHandle method, MemAddr data, const JitCallback::Parameters*, size_t, const JitCallback::Return* ret) {
-			const plugify::PropertyHandle retType = method.GetReturnType();
-			const bool hasHiddenParam = ValueUtils::IsHiddenParam(retType.GetType());
-
-			ArgsScope a(hasHiddenParam);
-			JitCall::Return r;
-
-			if (hasHiddenParam) {
-				BeginExternalCall(retType.GetType(), a);
+		// Element types which can be read from and written to buffer objects such as bytearray or array.array
+		template<typename T>
+		bool BufferMatches(const Py_buffer& view) {
+			if (view.itemsize != static_cast<Py_ssize_t>(sizeof(T))) {
+				return false;
 			}
-
-			using MakeExternalCallFunc = PyObject* (*)(PropertyHandle, JitCall::CallingFunc, const ArgsScope&, JitCall::Return&);
-			MakeExternalCallFunc const makeExternalCallFunc = retType.GetEnum() ? &MakeExternalCallWithEnumObject : &MakeExternalCallWithObject;
-			PyObject* const retObj = makeExternalCallFunc(retType, data.RCast<JitCall::CallingFunc>(), a, r);
-			if (!retObj) {
-				// makeExternalCallFunc set error
-				ret->SetReturn(nullptr);
-				return;
+			const char* format = view.format ? view.format : "B";
+			if (*format == '@' || *format == '=') {
+				++format;
+			}
+			if (format[0] == '\0' || format[1] != '\0') {
+				return false;
+			}
+			const std::string_view code(format, 1);
+			if constexpr (std::is_same_v<T, bool>) {
+				return code == "?";
+			} else if constexpr (std::is_same_v<T, char>) {
+				return code.find_first_of("cbB") == 0;
+			} else if constexpr (std::is_same_v<T, char16_t>) {
+				return code.find_first_of("uH") == 0;
+			} else if constexpr (std::is_same_v<T, void*>) {
+				return code.find_first_of("PLQ") == 0;
+			} else if constexpr (std::is_floating_point_v<T>) {
+				return code.find_first_of("fd") == 0;
+			} else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+				return code.find_first_of("bhilq") == 0;
+			} else if constexpr (std::is_integral_v<T>) {
+				return code.find_first_of("BHILQ") == 0;
+			} else {
+				return false;
 			}
-			ret->SetReturn(retObj);
 		}
 
-		void ExternalCall(MethodHandle method, MemAddr data, const JitCallback::Parameters* p, size_t, const JitCallback::Return* ret) {
-			// PyObject* (MethodPyCall*)(PyObject* self, PyObject* args)
-			const auto args = p->GetArgument<PyObject*>(1);
+		template<typename T>
+		constexpr bool IsBufferElement = std::is_arithmetic_v<T> || std::is_same_v<T, void*>;
+
+		template<typename T>
+		bool GetMatchingBuffer(PyObject* object, Py_buffer& view) {
+			if (PyObject_GetBuffer(object, &view, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0) {
+				return false;
+			}
+			if (!BufferMatches<T>(view)) {
+				PyBuffer_Release(&view);
+				SetTypeError("Buffer element type doesn't match reference parameter", object);
+				return false;
+			}
+			return true;
+		}
+
+		// In place mode passes lists and writable buffers of arrays, and one element lists as cells of other values
+		template<typename T>
+		bool PushInPlaceArrayParam(PropertyHandle paramType, PyObject* pItem, ArgsScope& a) {
+			if (IsNativeArray(pItem)) {
+				auto* const array = reinterpret_cast<NativeArrayObject*>(pItem);
+				if (array->ops != GetNativeArrayOps<T>() || !array->owned || !array->data || array->exports != 0) {
+					SetTypeError("Native array of other element type, borrowed or with buffers in use can't be updated in place", pItem);
+					return false;
+				}
+				// Native code changes vector owned by the array directly
+				a.refs.push_back(array->data);
+				a.params.AddArgument(array->data);
+				return true;
+			}
+			if (PyList_Check(pItem)) {
+				return PushObjectAsRefParam(paramType, pItem, a);
+			}
+			if constexpr (IsBufferElement<T>) {
+				if (PyObject_CheckBuffer(pItem)) {
+					Py_buffer view;
+					if (!GetMatchingBuffer<T>(pItem, view)) {
+						return false;
+					}
+					const auto* const data = static_cast<const T*>(view.buf);
+					auto* const value = new plg::vector<T>(data, data + view.len / view.itemsize);
+					PyBuffer_Release(&view);
+					a.storage.emplace_back(value, paramType.GetType());
+					a.refs.push_back(value);
+					a.params.AddArgument(static_cast<void*>(value));
+					return true;
+				}
+			}
+			SetTypeError("Expected list, writable buffer or native array to update in place", pItem);
+			return false;
+		}
+
+		bool PushObjectAsInPlaceRefParam(PropertyHandle paramType, PyObject* pItem, ArgsScope& a) {
+			switch (paramType.GetType()) {
+			case ValueType::ArrayBool:
+				return PushInPlaceArrayParam<bool>(paramType, pItem, a);
+			case ValueType::ArrayChar8:
+				return PushInPlaceArrayParam<char>(paramType, pItem, a);
+			case ValueType::ArrayChar16:
+				return PushInPlaceArrayParam<char16_t>(paramType, pItem, a);
+			case ValueType::ArrayInt8:
+				return PushInPlaceArrayParam<int8_t>(paramType, pItem, a);
+			case ValueType::ArrayInt16:
+				return PushInPlaceArrayParam<int16_t>(paramType, pItem, a);
+			case ValueType::ArrayInt32:
+				return PushInPlaceArrayParam<int32_t>(paramType, pItem, a);
+			case ValueType::ArrayInt64:
+				return PushInPlaceArrayParam<int64_t>(paramType, pItem, a);
+			case ValueType::ArrayUInt8:
+				return PushInPlaceArrayParam<uint8_t>(paramType, pItem, a);
+			case ValueType::ArrayUInt16:
+				return PushInPlaceArrayParam<uint16_t>(paramType, pItem, a);
+			case ValueType::ArrayUInt32:
+				return PushInPlaceArrayParam<uint32_t>(paramType, pItem, a);
+			case ValueType::ArrayUInt64:
+				return PushInPlaceArrayParam<uint64_t>(paramType, pItem, a);
+			case ValueType::ArrayPointer:
+				return PushInPlaceArrayParam<void*>(paramType, pItem, a);
+			case ValueType::ArrayFloat:
+				return PushInPlaceArrayParam<float>(paramType, pItem, a);
+			case ValueType::ArrayDouble:
+				return PushInPlaceArrayParam<double>(paramType, pItem, a);
+			case ValueType::ArrayString:
+				return PushInPlaceArrayParam<plg::string>(paramType, pItem, a);
+			case ValueType::ArrayAny:
+				return PushInPlaceArrayParam<plg::any>(paramType, pItem, a);
+			case ValueType::ArrayVector2:
+				return PushInPlaceArrayParam<plg::vec2>(paramType, pItem, a);
+			case ValueType::ArrayVector3:
+				return PushInPlaceArrayParam<plg::vec3>(paramType, pItem, a);
+			case ValueType::ArrayVector4:
+				return PushInPlaceArrayParam<plg::vec4>(paramType, pItem, a);
+			case ValueType::ArrayMatrix4x4:
+				return PushInPlaceArrayParam<plg::mat4x4>(paramType, pItem, a);
+			case ValueType::Vector2:
+			case ValueType::Vector3:
+			case ValueType::Vector4:
+			case ValueType::Matrix4x4:
+				// Objects of vector and matrix types are mutable themselves
+				return PushObjectAsRefParam(paramType, pItem, a);
+			default:
+				if (!PyList_Check(pItem) || PyList_GET_SIZE(pItem) != 1) {
+					SetTypeError("Expected one element list as a cell to update in place", pItem);
+					return false;
+				}
+				return PushObjectAsRefParam(paramType, PyList_GET_ITEM(pItem, 0), a);
+			}
+		}
+
+		// Used to keep list items whose value native code didn't change
+		template<typename T>
+		bool IsSameValue(PyObject* item, const T& value) {
+			if constexpr (std::is_same_v<T, bool>) {
+				return item == (value ? Py_True : Py_False);
+			} else if constexpr (std::is_floating_point_v<T>) {
+				return PyFloat_CheckExact(item) && PyFloat_AS_DOUBLE(item) == static_cast<double>(value);
+			} else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, char16_t>) {
+				if (!PyLong_CheckExact(item)) {
+					return false;
+				}
+				const auto current = ValueFromObject<T>(item);
+				if (!current) {
+					PyErr_Clear();
+					return false;
+				}
+				return *current == value;
+			} else if constexpr (std::is_same_v<T, plg::string>) {
+				if (!PyUnicode_CheckExact(item)) {
+					return false;
+				}
+				Py_ssize_t size;
+				const char* const data = PyUnicode_AsUTF8AndSize(item, &size);
+				if (!data) {
+					PyErr_Clear();
+					return false;
+				}
+				return std::string_view(data, static_cast<size_t>(size)) == std::string_view(value.data(), value.size());
+			} else if constexpr (std::is_same_v<T, plg::vec2> || std::is_same_v<T, plg::vec3> || std::is_same_v<T, plg::vec4>) {
+				const auto current = ValueFromObject<T>(item);
+				if (!current) {
+					PyErr_Clear();
+					return false;
+				}
+				return std::memcmp(&*current, &value, sizeof(T)) == 0;
+			} else {
+				return false;
+			}
+		}
+
+		// Elements are replaced only where values differ, the list grows or shrinks to the new size
+		template<typename T>
+		bool WriteBackList(PyObject* list, const plg::vector<T>& array) {
+			const auto size = static_cast<Py_ssize_t>(array.size());
+			const Py_ssize_t oldSize = PyList_GET_SIZE(list);
+			for (Py_ssize_t i = 0; i < size; ++i) {
+				const T& value = array[static_cast<size_t>(i)];
+				if (i < oldSize && IsSameValue(PyList_GET_ITEM(list, i), value)) {
+					continue;
+				}
+				PyObject* const valueObject = CreatePyObject(value);
+				if (!valueObject) {
+					return false;
+				}
+				if (i < oldSize) {
+					PyList_SetItem(list, i, valueObject);
+				} else {
+					const int result = PyList_Append(list, valueObject);
+					Py_DECREF(valueObject);
+					if (result < 0) {
+						return false;
+					}
+				}
+			}
+			return size >= oldSize || PyList_SetSlice(list, size, oldSize, nullptr) == 0;
+		}
+
+		template<typename T>
+		bool WriteBackBuffer(PyObject* object, const plg::vector<T>& array) {
+			const size_t bytes = array.size() * sizeof(T);
+			Py_buffer view;
+			if (!GetMatchingBuffer<T>(object, view)) {
+				return false;
+			}
+			if (static_cast<size_t>(view.len) == bytes) {
+				std::memcpy(view.buf, array.data(), bytes);
+				PyBuffer_Release(&view);
+				return true;
+			}
+			PyBuffer_Release(&view);
+			if (PyByteArray_Check(object)) {
+				if (PyByteArray_Resize(object, static_cast<Py_ssize_t>(bytes)) < 0) {
+					return false;
+				}
+				std::memcpy(PyByteArray_AS_STRING(object), array.data(), bytes);
+				return true;
+			}
+			// array.array and alike are refilled through their sequence interface
+			if (PySequence_DelSlice(object, 0, PY_SSIZE_T_MAX) < 0) {
+				return false;
+			}
+			PyObject* const result = PyObject_CallMethod(object, "frombytes", "y#", reinterpret_cast<const char*>(array.data()), static_cast<Py_ssize_t>(bytes));
+			if (!result) {
+				return false;
+			}
+			Py_DECREF(result);
+			return true;
+		}
+
+		template<typename T>
+		bool WriteBackArray(PyObject* object, const void* value) {
+			const auto& array = *static_cast<const plg::vector<T>*>(value);
+			if (IsNativeArray(object)) {
+				RefreshNativeArray(object, static_cast<Py_ssize_t>(array.size()));
+				return true;
+			}
+			if (PyList_Check(object)) {
+				return WriteBackList(object, array);
+			}
+			if constexpr (IsBufferElement<T>) {
+				return WriteBackBuffer(object, array);
+			} else {
+				return false;
+			}
+		}
+
+		// Native code may run python which empties the cell before it is written back
+		bool CheckCell(PyObject* cell) {
+			if (PyList_GET_SIZE(cell) != 1) {
+				SetTypeError("Expected one element list as a cell to update in place", cell);
+				return false;
+			}
+			return true;
+		}
+
+		template<typename T>
+		bool WriteBackCell(PyObject* cell, const void* value) {
+			if (!CheckCell(cell)) {
+				return false;
+			}
+			const T& current = *static_cast<const T*>(value);
+			if (IsSameValue(PyList_GET_ITEM(cell, 0), current)) {
+				return true;
+			}
+			PyObject* const valueObject = CreatePyObject(current);
+			return valueObject && PyList_SetItem(cell, 0, valueObject) == 0;
+		}
+
+		template<size_t N>
+		bool WriteBackVector(PyObject* object, const float* values) {
+			double* const data = reinterpret_cast<VectorObject<N>*>(object)->data;
+			for (size_t i = 0; i < N; ++i) {
+				data[i] = static_cast<double>(values[i]);
+			}
+			return true;
+		}
+
+		bool WriteBackMatrix(PyObject* object, const plg::mat4x4& matrix) {
+			PyObject* const valueObject = CreatePyObject(matrix);
+			if (!valueObject) {
+				return false;
+			}
+			auto* const target = reinterpret_cast<Matrix4x4Object*>(object);
+			Py_XSETREF(target->m, Py_XNewRef(reinterpret_cast<Matrix4x4Object*>(valueObject)->m));
+			Py_DECREF(valueObject);
+			return true;
+		}
+
+		// Enum values are written as members, into the list cell or as new contents of the list
+		bool WriteBackEnum(PropertyHandle paramType, PyObject* object, const void* value) {
+			PyObject* const valueObject = StorageValueToEnumObject(paramType, value);
+			if (!valueObject) {
+				return false;
+			}
+			int result;
+			if (PyList_Check(valueObject)) {
+				result = PyList_SetSlice(object, 0, PY_SSIZE_T_MAX, valueObject);
+				Py_DECREF(valueObject);
+			} else if (CheckCell(object)) {
+				result = PyList_SetItem(object, 0, valueObject);
+			} else {
+				Py_DECREF(valueObject);
+				return false;
+			}
+			return result == 0;
+		}
+
+		bool WriteBackRefParam(PropertyHandle paramType, PyObject* object, const void* value) {
+			if (paramType.GetEnum() && PyList_Check(object)) {
+				return WriteBackEnum(paramType, object, value);
+			}
+			switch (paramType.GetType()) {
+			case ValueType::Bool:
+				return WriteBackCell<bool>(object, value);
+			case ValueType::Char8:
+				return WriteBackCell<char>(object, value);
+			case ValueType::Char16:
+				return WriteBackCell<char16_t>(object, value);
+			case ValueType::Int8:
+				return WriteBackCell<int8_t>(object, value);
+			case ValueType::Int16:
+				return WriteBackCell<int16_t>(object, value);
+			case ValueType::Int32:
+				return WriteBackCell<int32_t>(object, value);
+			case ValueType::Int64:
+				return WriteBackCell<int64_t>(object, value);
+			case ValueType::UInt8:
+				return WriteBackCell<uint8_t>(object, value);
+			case ValueType::UInt16:
+				return WriteBackCell<uint16_t>(object, value);
+			case ValueType::UInt32:
+				return WriteBackCell<uint32_t>(object, value);
+			case ValueType::UInt64:
+				return WriteBackCell<uint64_t>(object, value);
+			case ValueType::Pointer:
+				return WriteBackCell<void*>(object, value);
+			case ValueType::Float:
+				return WriteBackCell<float>(object, value);
+			case ValueType::Double:
+				return WriteBackCell<double>(object, value);
+			case ValueType::String:
+				return WriteBackCell<plg::string>(object, value);
+			case ValueType::Any:
+				return WriteBackCell<plg::any>(object, value);
+			case ValueType::ArrayBool:
+				return WriteBackArray<bool>(object, value);
+			case ValueType::ArrayChar8:
+				return WriteBackArray<char>(object, value);
+			case ValueType::ArrayChar16:
+				return WriteBackArray<char16_t>(object, value);
+			case ValueType::ArrayInt8:
+				return WriteBackArray<int8_t>(object, value);
+			case ValueType::ArrayInt16:
+				return WriteBackArray<int16_t>(object, value);
+			case ValueType::ArrayInt32:
+				return WriteBackArray<int32_t>(object, value);
+			case ValueType::ArrayInt64:
+				return WriteBackArray<int64_t>(object, value);
+			case ValueType::ArrayUInt8:
+				return WriteBackArray<uint8_t>(object, value);
+			case ValueType::ArrayUInt16:
+				return WriteBackArray<uint16_t>(object, value);
+			case ValueType::ArrayUInt32:
+				return WriteBackArray<uint32_t>(object, value);
+			case ValueType::ArrayUInt64:
+				return WriteBackArray<uint64_t>(object, value);
+			case ValueType::ArrayPointer:
+				return WriteBackArray<void*>(object, value);
+			case ValueType::ArrayFloat:
+				return WriteBackArray<float>(object, value);
+			case ValueType::ArrayDouble:
+				return WriteBackArray<double>(object, value);
+			case ValueType::ArrayString:
+				return WriteBackArray<plg::string>(object, value);
+			case ValueType::ArrayAny:
+				return WriteBackArray<plg::any>(object, value);
+			case ValueType::ArrayVector2:
+				return WriteBackArray<plg::vec2>(object, value);
+			case ValueType::ArrayVector3:
+				return WriteBackArray<plg::vec3>(object, value);
+			case ValueType::ArrayVector4:
+				return WriteBackArray<plg::vec4>(object, value);
+			case ValueType::ArrayMatrix4x4:
+				return WriteBackArray<plg::mat4x4>(object, value);
+			case ValueType::Vector2:
+				return WriteBackVector<2>(object, &static_cast<const plg::vec2*>(value)->x);
+			case ValueType::Vector3:
+				return WriteBackVector<3>(object, &static_cast<const plg::vec3*>(value)->x);
+			case ValueType::Vector4:
+				return WriteBackVector<4>(object, &static_cast<const plg::vec4*>(value)->x);
+			case ValueType::Matrix4x4:
+				return WriteBackMatrix(object, *static_cast<const plg::mat4x4*>(value));
+			default: {
+				const std::string error(std::format("WriteBackRefParam unsupported type {:#x}", static_cast<uint8_t>(paramType.GetType())));
+				PyErr_SetString(PyExc_RuntimeError, error.c_str());
+				return false;
+			}
+			}
+		}
+
+		// PyObject* (MethodPyCall*)(PyObject* self, PyObject* args)
+		void ExternalCallNoArgs(MethodHandle method, MemAddr data, const JitCallback::Parameters* p, size_t, const JitCallback::Return* ret) {
+			CallOptionsScope optionsScope(GetCallOptions(p->GetArgument<PyObject*>(0)));
+
+			const plugify::PropertyHandle retType = method.GetReturnType();
+			const bool hasHiddenParam = ValueUtils::IsHiddenParam(retType.GetType());
+
+			ArgsScope a(hasHiddenParam);
+			JitCall::Return r;
+
+			if (hasHiddenParam) {
+				BeginExternalCall(retType.GetType(), a);
+			}
+
+			using MakeExternalCallFunc = PyObject* (*)(PropertyHandle, JitCall::CallingFunc, const ArgsScope&, JitCall::Return&);
+			MakeExternalCallFunc const makeExternalCallFunc = retType.GetEnum() ? &MakeExternalCallWithEnumObject : &MakeExternalCallWithObject;
+			PyObject* const retObj = makeExternalCallFunc(retType, data.RCast<JitCall::CallingFunc>(), a, r);
+			if (!retObj) {
+				// makeExternalCallFunc set error
+				ret->SetReturn(nullptr);
+				return;
+			}
+			ret->SetReturn(retObj);
+		}
+
+		void ExternalCall(MethodHandle method, MemAddr data, const JitCallback::Parameters* p, size_t, const JitCallback::Return* ret) {
+			// PyObject* (MethodPyCall*)(PyObject* self, PyObject* args)
+			const auto args = p->GetArgument<PyObject*>(1);
+			CallOptionsScope optionsScope(GetCallOptions(p->GetArgument<PyObject*>(0)));
 
 			if (!PyTuple_Check(args)) {
 				const std::string error(std::format("Function \"{}\" expects a tuple of arguments", method.GetFunctionName()));
@@ -2958,13 +4136,16 @@ namespace py3lm {
 				BeginExternalCall(retType.GetType(), a);
 			}
 
+			// Arguments of reference parameters are updated instead of being returned in a tuple
+			const bool inPlace = currentCallOptions->inPlaceRefs;
+
 			for (Py_ssize_t i = 0; i < size; ++i) {
 				const PropertyHandle paramType = paramTypes[i];
 				if (paramType.IsReference()) {
 					++refParamsCount;
 				}
 				using PushParamFunc = bool (*)(PropertyHandle, PyObject*, ArgsScope&);
-				PushParamFunc const pushParamFunc = paramType.IsReference() ? &PushObjectAsRefParam : &PushObjectAsParam;
+				PushParamFunc const pushParamFunc = paramType.IsReference() ? (inPlace ? &PushObjectAsInPlaceRefParam : &PushObjectAsRefParam) : &PushObjectAsParam;
 				const bool pushResult = pushParamFunc(paramType, PyTuple_GetItem(args, i), a);
 				if (!pushResult) {
 					// pushParamFunc set error
@@ -2982,89 +4163,616 @@ namespace py3lm {
 				return;
 			}
 
-			if (refParamsCount) {
+			if (refParamsCount && inPlace) {
+				size_t k = 0;
+				for (Py_ssize_t i = 0; i < size; ++i) {
+					const PropertyHandle paramType = paramTypes[i];
+					if (!paramType.IsReference()) {
+						continue;
+					}
+					if (!WriteBackRefParam(paramType, PyTuple_GET_ITEM(args, i), a.refs[k++])) {
+						// WriteBackRefParam set error
+						Py_DECREF(retObj);
+						ret->SetReturn(nullptr);
+						return;
+					}
+				}
+			} else if (refParamsCount) {
 				PyObject* const retTuple = PyTuple_New(1 + refParamsCount);
 
-				Py_ssize_t k = 0;
+				Py_ssize_t k = 0;
+
+				PyTuple_SET_ITEM(retTuple, k++, retObj); // retObj ref taken by tuple
+
+				for (Py_ssize_t i = 0; i < size; ++i) {
+					const PropertyHandle paramType = paramTypes[i];
+					if (!paramType.IsReference()) {
+						continue;
+					}
+					using StoreValueFunc = PyObject* (*)(PropertyHandle, const void*);
+					StoreValueFunc const storeValueFunc = paramType.GetEnum() ? &StorageValueToEnumObject : &StorageValueToObject;
+					PyObject* const value = storeValueFunc(paramType, a.refs[static_cast<size_t>(k - 1)]);
+					if (!value) {
+						// StorageValueToObject set error
+						Py_DECREF(retTuple);
+						ret->SetReturn(nullptr);
+						return;
+					}
+					PyTuple_SET_ITEM(retTuple, k++, value);
+					if (k >= refParamsCount + 1) {
+						break;
+					}
+				}
+
+				retObj = retTuple;
+			}
+
+			ret->SetReturn(retObj);
+		}
+
+		template<typename T>
+		std::optional<T> GetObjectAttrAsValue(PyObject* object, const char* attr_name) {
+			PyObject* const attrObject = PyObject_GetAttrString(object, attr_name);
+			if (!attrObject) {
+				// PyObject_GetAttrString set error. e.g. AttributeError
+				return std::nullopt;
+			}
+			const auto value = ValueFromObject<T>(attrObject);
+			// ValueFromObject set error. e.g. TypeError
+			Py_DECREF(attrObject);
+			return value;
+		}
+
+		std::optional<double> GetObjectAttrAsNumber(PyObject* object, const char* attr_name) {
+			PyObject* const attrObject = PyObject_GetAttrString(object, attr_name);
+			if (!attrObject) {
+				// PyObject_GetAttrString set error. e.g. AttributeError
+				return std::nullopt;
+			}
+			// int, float or any object with __float__/__index__
+			const double value = PyFloat_AsDouble(attrObject);
+			Py_DECREF(attrObject);
+			if (value == -1.0 && PyErr_Occurred()) {
+				return std::nullopt;
+			}
+			return value;
+		}
+
+		bool IsTaskDone(PyObject* task) {
+			PyObject* const result = PyObject_CallMethod(task, "done", nullptr);
+			if (!result) {
+				g_py3lm.LogError();
+				return true;
+			}
+			const int done = PyObject_IsTrue(result);
+			Py_DECREF(result);
+			return done != 0;
+		}
+
+		void CancelTask(PyObject* task) {
+			PyObject* const result = PyObject_CallMethod(task, "cancel", nullptr);
+			if (!result) {
+				g_py3lm.LogError();
+				return;
+			}
+			Py_DECREF(result);
+		}
+
+		void GenerateEnum(MethodHandle method, PyObject* moduleDict);
+
+		void GenerateEnum(PropertyHandle paramType, PyObject* moduleDict) {
+			if (const auto prototype = paramType.GetPrototype()) {
+				GenerateEnum(prototype, moduleDict);
+			}
+			if (const auto enumerator = paramType.GetEnum()) {
+				g_py3lm.CreateEnumObject(enumerator, moduleDict);
+			}
+		}
+
+		void GenerateEnum(MethodHandle method, PyObject* moduleDict) {
+			GenerateEnum(method.GetReturnType(), moduleDict);
+			for (const auto& paramType : method.GetParamTypes()) {
+				GenerateEnum(paramType, moduleDict);
+			}
+		}
+
+		PyObject* CustomPrint(PyObject* self, PyObject* args, PyObject* kwargs) {
+			PyObject* sep = PyUnicode_FromString(" ");
+			PyObject* end = PyUnicode_FromString("\n");
+
+			static std::array kwlist = { const_cast<char*>("sep"), const_cast<char*>("end"), static_cast<char *>(nullptr) };
+			if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OO", kwlist.data(), &sep, &end)) {
+				return nullptr;
+			}
+
+			PyObject* message = PyUnicode_Join(sep, args);
+			if (!message) {
+				return nullptr;
+			}
+
+			g_py3lm.GetProvider()->Log(PyUnicode_AsString(message), plugify::Severity::None);
+
+			Py_DECREF(message);
+			Py_RETURN_NONE;
+		}
+
+		PyObject* TimersCallLater(PyObject* self, PyObject* args) {
+			double delay;
+			PyObject* callback;
+			if (!PyArg_ParseTuple(args, "dO:call_later", &delay, &callback)) {
+				return nullptr;
+			}
+			return g_py3lm.ScheduleTimer(delay, 0.0, callback);
+		}
+
+		PyObject* TimersCallRepeating(PyObject* self, PyObject* args) {
+			double interval;
+			PyObject* callback;
+			if (!PyArg_ParseTuple(args, "dO:call_repeating", &interval, &callback)) {
+				return nullptr;
+			}
+			if (interval <= 0.0) {
+				PyErr_SetString(PyExc_ValueError, "Interval should be positive");
+				return nullptr;
+			}
+			return g_py3lm.ScheduleTimer(interval, interval, callback);
+		}
+
+		PyObject* TimersCancel(PyObject* self, PyObject* handle) {
+			return g_py3lm.CancelTimer(handle);
+		}
+
+		std::array<PyMethodDef, 4> TimersMethods = {{
+			{ "call_later", &TimersCallLater, METH_VARARGS, "call_later(delay, callback) -> handle\n\nCall callback once after delay seconds." },
+			{ "call_repeating", &TimersCallRepeating, METH_VARARGS, "call_repeating(interval, callback) -> handle\n\nCall callback every interval seconds." },
+			{ "cancel", &TimersCancel, METH_O, "cancel(handle) -> bool\n\nCancel timer, returns False if it already expired or was cancelled." },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		PyModuleDef TimersModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify.timers",
+			"Timers driven by host update",
+			-1,
+			TimersMethods.data()
+		};
+
+		PyObject* AioWake(PyObject* self, PyObject*) {
+			g_py3lm.WakeEventLoop();
+			Py_RETURN_NONE;
+		}
+
+		std::array<PyMethodDef, 2> AioMethods = {{
+			{ "wake", &AioWake, METH_NOARGS, "wake()\n\nMark event loop of plugify.aio as having work, host update steps it until it is idle again." },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		PyModuleDef AioModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify._aio",
+			"Native side of plugify.aio event loop",
+			-1,
+			AioMethods.data()
+		};
+
+		PyObject* CollectorEnable(PyObject* self, PyObject* args, PyObject* kwargs) {
+			double budget = 0.001;
+			double fullInterval = 0.0;
+			static std::array kwlist = { const_cast<char*>("budget"), const_cast<char*>("full_interval"), static_cast<char *>(nullptr) };
+			if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|dd:enable", kwlist.data(), &budget, &fullInterval)) {
+				return nullptr;
+			}
+			if (!std::isfinite(budget) || !std::isfinite(fullInterval) || budget < 0.0 || fullInterval < 0.0) {
+				PyErr_SetString(PyExc_ValueError, "Time should be non-negative finite number of seconds");
+				return nullptr;
+			}
+			return g_py3lm.EnableCollector(budget, fullInterval);
+		}
+
+		PyObject* CollectorDisable(PyObject* self, PyObject*) {
+			return g_py3lm.DisableCollector();
+		}
+
+		PyObject* CollectorCollectIdle(PyObject* self, PyObject*) {
+			return g_py3lm.RequestFullCollection();
+		}
+
+		PyObject* CollectorStats(PyObject* self, PyObject*) {
+			return g_py3lm.GetCollectorStats();
+		}
+
+		std::array<PyMethodDef, 5> CollectorMethods = {{
+			{ "enable", reinterpret_cast<PyCFunction>(&CollectorEnable), METH_VARARGS | METH_KEYWORDS, "enable(budget=0.001, full_interval=0.0)\n\nDisable automatic garbage collection, freeze objects after plugins are loaded and collect young generations between frames within budget seconds." },
+			{ "disable", &CollectorDisable, METH_NOARGS, "disable()\n\nReturn to automatic garbage collection." },
+			{ "collect_idle", &CollectorCollectIdle, METH_NOARGS, "collect_idle()\n\nMark idle point, full collection runs on next host update." },
+			{ "stats", &CollectorStats, METH_NOARGS, "stats() -> dict\n\nGarbage collection pause times in seconds and collection counts." },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		PyModuleDef CollectorModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify.collector",
+			"Frame aware garbage collection scheduler",
+			-1,
+			CollectorMethods.data()
+		};
+
+		// Returns new function object sharing the native function with options changed by modify
+		template<typename F>
+		PyObject* WithCallOptions(PyObject* func, F&& modify) {
+			if (!g_py3lm.IsExternalFunction(func)) {
+				SetTypeError("Expected native function", func);
+				return nullptr;
+			}
+			auto* const cfunc = reinterpret_cast<PyCFunctionObject*>(func);
+			auto options = std::make_unique<CallOptions>(GetCallOptions(cfunc->m_self));
+			modify(*options);
+			PyObject* const capsule = PyCapsule_New(options.get(), CallOptionsCapsuleName, [](PyObject* object) {
+				delete static_cast<CallOptions*>(PyCapsule_GetPointer(object, CallOptionsCapsuleName));
+			});
+			if (!capsule) {
+				return nullptr;
+			}
+			options.release();
+			PyObject* const object = PyCFunction_NewEx(cfunc->m_ml, capsule, cfunc->m_module);
+			Py_DECREF(capsule);
+			return object;
+		}
+
+		PyObject* StringsEnableCache(PyObject* self, PyObject* args, PyObject* kwargs) {
+			Py_ssize_t capacity = 4096;
+			Py_ssize_t maxLength = 64;
+			static std::array kwlist = { const_cast<char*>("capacity"), const_cast<char*>("max_length"), static_cast<char *>(nullptr) };
+			if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|nn:enable_cache", kwlist.data(), &capacity, &maxLength)) {
+				return nullptr;
+			}
+			if (capacity < 0 || maxLength < 0 || capacity > (Py_ssize_t{ 1 } << 24)) {
+				PyErr_SetString(PyExc_ValueError, "Capacity should be in range [0, 16777216] and max_length non-negative");
+				return nullptr;
+			}
+			return g_py3lm.EnableStringCache(capacity, maxLength);
+		}
+
+		PyObject* StringsDisableCache(PyObject* self, PyObject*) {
+			return g_py3lm.DisableStringCache();
+		}
+
+		PyObject* StringsCacheStats(PyObject* self, PyObject*) {
+			return g_py3lm.GetStringCacheStats();
+		}
+
+		PyObject* StringsCharArrays(PyObject* self, PyObject* func) {
+			if (g_py3lm.IsExternalFunction(func)) {
+				return WithCallOptions(func, [](CallOptions& options) { options.charArraysAsStr = true; });
+			}
+			if (!PyCallable_Check(func)) {
+				SetTypeError("Expected callable", func);
+				return nullptr;
+			}
+			if (PyObject_SetAttrString(func, "__plugify_char_arrays__", Py_True) < 0) {
+				return nullptr;
+			}
+			return Py_NewRef(func);
+		}
+
+		std::array<PyMethodDef, 5> StringsMethods = {{
+			{ "enable_cache", reinterpret_cast<PyCFunction>(&StringsEnableCache), METH_VARARGS | METH_KEYWORDS, "enable_cache(capacity=4096, max_length=64)\n\nReuse str objects for native strings up to max_length bytes, most recent string per cache slot is kept." },
+			{ "disable_cache", &StringsDisableCache, METH_NOARGS, "disable_cache()\n\nRelease cached strings and create a new str for every native string." },
+			{ "char_arrays", &StringsCharArrays, METH_O, "char_arrays(func) -> func\n\nDecorator of callbacks, or wrapper of native functions. char8[] and char16[] values passed to the callback or returned from the function are a single str instead of a list of characters." },
+			{ "cache_stats", &StringsCacheStats, METH_NOARGS, "cache_stats() -> dict\n\nCache size and hit/miss counters since it was enabled." },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		PyModuleDef StringsModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify.strings",
+			"Cache of str objects for strings passed from native code and str character arrays",
+			-1,
+			StringsMethods.data()
+		};
+
+		PyObject* ArraysLazy(PyObject* self, PyObject* args, PyObject* kwargs) {
+			PyObject* func;
+			Py_ssize_t minSize = 256;
+			static std::array kwlist = { const_cast<char*>("func"), const_cast<char*>("min_size"), static_cast<char *>(nullptr) };
+			if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|n:lazy", kwlist.data(), &func, &minSize)) {
+				return nullptr;
+			}
+			if (minSize < 1) {
+				PyErr_SetString(PyExc_ValueError, "min_size should be positive");
+				return nullptr;
+			}
+			if (g_py3lm.IsExternalFunction(func)) {
+				return WithCallOptions(func, [minSize](CallOptions& options) { options.lazyArrayMinSize = static_cast<size_t>(minSize); });
+			}
+			if (!PyCallable_Check(func)) {
+				SetTypeError("Expected callable", func);
+				return nullptr;
+			}
+			PyObject* const minSizeObject = PyLong_FromSsize_t(minSize);
+			if (!minSizeObject) {
+				return nullptr;
+			}
+			const int result = PyObject_SetAttrString(func, "__plugify_lazy_arrays__", minSizeObject);
+			Py_DECREF(minSizeObject);
+			if (result < 0) {
+				return nullptr;
+			}
+			return Py_NewRef(func);
+		}
+
+		PyObject* ArraysNativeReturns(PyObject* self, PyObject* func) {
+			return WithCallOptions(func, [](CallOptions& options) { options.nativeReturns = true; });
+		}
+
+		std::array<PyMethodDef, 3> ArraysMethods = {{
+			{ "lazy", reinterpret_cast<PyCFunction>(&ArraysLazy), METH_VARARGS | METH_KEYWORDS, "lazy(func, min_size=256) -> func\n\nDecorator of callbacks, or wrapper of native functions. Arrays of strings, any values, vectors and matrices with at least min_size elements passed to the callback or returned from the function are NativeArray, which converts elements on first access. Elements of arrays passed to callbacks are copied when the array outlives the call." },
+			{ "native_returns", &ArraysNativeReturns, METH_O, "native_returns(func) -> func\n\nReturn native function which keeps every returned array in a NativeArray, which owns the vector, provides a read only buffer for plain values and is passed back to native calls without conversion." },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		PyModuleDef ArraysModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify.arrays",
+			"Lazy conversion and ownership of arrays passed from native code",
+			-1,
+			ArraysMethods.data()
+		};
+
+		PyObject* HandlesRef(PyObject* self, PyObject* object) {
+			return g_py3lm.RefObjectHandle(object);
+		}
+
+		PyObject* HandlesGet(PyObject* self, PyObject* handle) {
+			return g_py3lm.ResolveObjectHandle(handle);
+		}
+
+		PyObject* HandlesRelease(PyObject* self, PyObject* handle) {
+			return g_py3lm.ReleaseObjectHandle(handle);
+		}
+
+		PyObject* HandlesCount(PyObject* self, PyObject*) {
+			return g_py3lm.GetObjectHandleCount();
+		}
+
+		std::array<PyMethodDef, 5> HandlesMethods = {{
+			{ "ref", &HandlesRef, METH_O, "ref(obj) -> int\n\nReturn handle of obj to pass to pointer parameters and pin it once more." },
+			{ "get", &HandlesGet, METH_O, "get(handle) -> object\n\nReturn object of a live handle." },
+			{ "release", &HandlesRelease, METH_O, "release(handle)\n\nUnpin handle, object is dropped and handle invalidated when no pins are left." },
+			{ "count", &HandlesCount, METH_NOARGS, "count() -> int\n\nNumber of live handles." },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		PyModuleDef HandlesModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify.handles",
+			"Opaque handles of python objects passed through native code",
+			-1,
+			HandlesMethods.data()
+		};
+
+		PyObject* RefsViews(PyObject* self, PyObject* func) {
+			if (!PyCallable_Check(func)) {
+				SetTypeError("Expected callable", func);
+				return nullptr;
+			}
+			if (PyObject_SetAttrString(func, "__plugify_ref_views__", Py_True) < 0) {
+				return nullptr;
+			}
+			return Py_NewRef(func);
+		}
+
+		PyObject* RefsInPlace(PyObject* self, PyObject* func) {
+			return WithCallOptions(func, [](CallOptions& options) { options.inPlaceRefs = true; });
+		}
+
+		std::array<PyMethodDef, 3> RefsMethods = {{
+			{ "views", &RefsViews, METH_O, "views(func) -> func\n\nDecorator of callbacks called from native code. Reference parameters are passed as Ref objects which read and write native memory directly, the callback returns only its return value." },
+			{ "in_place", &RefsInPlace, METH_O, "in_place(func) -> func\n\nReturn native function which updates arguments of its reference parameters in place instead of returning their values in a tuple. Arrays are passed as lists, writable buffers or NativeArray, vectors and matrices as their objects and other values as one element lists." },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
 
-				PyTuple_SET_ITEM(retTuple, k++, retObj); // retObj ref taken by tuple
+		PyModuleDef RefsModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify.refs",
+			"Reference parameters passed as mutable views",
+			-1,
+			RefsMethods.data()
+		};
 
-				for (Py_ssize_t i = 0, j = hasHiddenParam; i < size; ++i) {
-					const PropertyHandle paramType = paramTypes[i];
-					if (!paramType.IsReference()) {
-						continue;
-					}
-					using StoreValueFunc = PyObject* (*)(PropertyHandle, const ArgsScope&, size_t);
-					StoreValueFunc const storeValueFunc = paramType.GetEnum() ? &StorageValueToEnumObject : &StorageValueToObject;
-					PyObject* const value = storeValueFunc(paramType, a, j++);
-					if (!value) {
-						// StorageValueToObject set error
-						Py_DECREF(retTuple);
-						ret->SetReturn(nullptr);
-						return;
-					}
-					PyTuple_SET_ITEM(retTuple, k++, value);
-					if (k >= refParamsCount + 1) {
-						break;
-					}
+		// Returns first of candidate directories which can be created and written to
+		std::optional<fs::path> FindWritableDirectory(std::initializer_list<fs::path> candidates) {
+			for (const auto& candidate : candidates) {
+				std::error_code ec;
+				fs::create_directories(candidate, ec);
+				if (ec || !fs::is_directory(candidate, ec)) {
+					continue;
 				}
-
-				retObj = retTuple;
+				constexpr auto writePerms = fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write;
+				const fs::file_status status = fs::status(candidate, ec);
+				if (ec || (status.permissions() & writePerms) == fs::perms::none) {
+					continue;
+				}
+				return candidate;
 			}
-
-			ret->SetReturn(retObj);
+			return std::nullopt;
 		}
 
-		template<typename T>
-		std::optional<T> GetObjectAttrAsValue(PyObject* object, const char* attr_name) {
-			PyObject* const attrObject = PyObject_GetAttrString(object, attr_name);
-			if (!attrObject) {
-				// PyObject_GetAttrString set error. e.g. AttributeError
-				return std::nullopt;
+		// Validates pyc header the same way as import system does for timestamp based pycs
+		bool IsBytecodeCached(PyObject* cacheFromSource, const fs::path& sourcePath) {
+			const std::u8string sourceString = sourcePath.u8string();
+			PyObject* const sourceObject = PyUnicode_FromStringAndSize(reinterpret_cast<const char*>(sourceString.data()), static_cast<Py_ssize_t>(sourceString.size()));
+			if (!sourceObject) {
+				PyErr_Clear();
+				return false;
 			}
-			const auto value = ValueFromObject<T>(attrObject);
-			// ValueFromObject set error. e.g. TypeError
-			Py_DECREF(attrObject);
-			return value;
-		}
+			PyObject* const cacheObject = PyObject_CallOneArg(cacheFromSource, sourceObject);
+			Py_DECREF(sourceObject);
+			if (!cacheObject) {
+				PyErr_Clear();
+				return false;
+			}
+			const char* const cacheString = PyUnicode_AsUTF8(cacheObject);
+			if (!cacheString) {
+				Py_DECREF(cacheObject);
+				PyErr_Clear();
+				return false;
+			}
+			const fs::path cachePath(reinterpret_cast<const char8_t*>(cacheString));
+			Py_DECREF(cacheObject);
 
-		void GenerateEnum(MethodHandle method, PyObject* moduleDict);
+			// magic, flags, source mtime, source size
+			std::array<uint32_t, 4> header{};
+			std::ifstream file(cachePath, std::ios::binary);
+			if (!file.read(reinterpret_cast<char*>(header.data()), sizeof(header))) {
+				return false;
+			}
+			if (header[0] != static_cast<uint32_t>(PyImport_GetMagicNumber())) {
+				return false;
+			}
+			if (header[1] != 0) {
+				// Hash based pyc, checked by import system against source
+				return true;
+			}
 
-		void GenerateEnum(PropertyHandle paramType, PyObject* moduleDict) {
-			if (const auto prototype = paramType.GetPrototype()) {
-				GenerateEnum(prototype, moduleDict);
+			std::error_code ec;
+			const auto sourceTime = fs::last_write_time(sourcePath, ec);
+			if (ec) {
+				return false;
 			}
-			if (const auto enumerator = paramType.GetEnum()) {
-				g_py3lm.CreateEnumObject(enumerator, moduleDict);
+			const auto sourceSize = fs::file_size(sourcePath, ec);
+			if (ec) {
+				return false;
 			}
+#if PY3LM_PLATFORM_WINDOWS
+			const auto sourceSystemTime = std::chrono::clock_cast<std::chrono::system_clock>(sourceTime);
+#else
+			const auto sourceSystemTime = fs::file_time_type::clock::to_sys(sourceTime);
+#endif
+			const auto sourceSeconds = std::chrono::duration_cast<std::chrono::seconds>(sourceSystemTime.time_since_epoch()).count();
+			return header[2] == static_cast<uint32_t>(sourceSeconds) && header[3] == static_cast<uint32_t>(sourceSize);
 		}
 
-		void GenerateEnum(MethodHandle method, PyObject* moduleDict) {
-			GenerateEnum(method.GetReturnType(), moduleDict);
-			for (const auto& paramType : method.GetParamTypes()) {
-				GenerateEnum(paramType, moduleDict);
+		// Builtin and frozen importers come first in sys.meta_path, finder goes right before the path based one
+		bool InsertIntoMetaPath(PyObject* metaPath, PyObject* finder) {
+			const Py_ssize_t size = PyList_Size(metaPath);
+			Py_ssize_t index = 0;
+			for (; index < size; ++index) {
+				PyObject* const name = PyObject_GetAttrString(PyList_GET_ITEM(metaPath, index), "__name__");
+				if (!name) {
+					PyErr_Clear();
+					continue;
+				}
+				const bool pathFinder = PyUnicode_Check(name) && PyUnicode_CompareWithASCIIString(name, "PathFinder") == 0;
+				Py_DECREF(name);
+				if (pathFinder) {
+					break;
+				}
 			}
+			return PyList_Insert(metaPath, index, finder) == 0;
 		}
 
-		PyObject* CustomPrint(PyObject* self, PyObject* args, PyObject* kwargs) {
-			PyObject* sep = PyUnicode_FromString(" ");
-			PyObject* end = PyUnicode_FromString("\n");
+		void RemoveFromMetaPath(PyObject* finder) {
+			if (PyObject* const metaPath = PySys_GetObject("meta_path")) {
+				if (PyObject* const returnObject = PyObject_CallMethod(metaPath, "remove", "O", finder)) {
+					Py_DECREF(returnObject);
+				} else {
+					PyErr_Clear();
+				}
+			}
+		}
 
-			static std::array kwlist = { const_cast<char*>("sep"), const_cast<char*>("end"), static_cast<char *>(nullptr) };
-			if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OO", kwlist.data(), &sep, &end)) {
+		// sys.meta_path finder and loader for modules packed into memory mapped archives
+		PyObject* ArchiveFinderFindSpec(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+			if (nargs < 1 || !PyUnicode_Check(args[0])) {
+				PyErr_SetString(PyExc_TypeError, "find_spec expects module name");
 				return nullptr;
 			}
+			return g_py3lm.FindArchiveSpec(args[0], self);
+		}
 
-			PyObject* message = PyUnicode_Join(sep, args);
-			if (!message) {
+		PyObject* ArchiveFinderCreateModule(PyObject* self, PyObject* spec) {
+			// Default module creation
+			Py_RETURN_NONE;
+		}
+
+		PyObject* ArchiveFinderExecModule(PyObject* self, PyObject* module) {
+			return g_py3lm.ExecArchiveModule(module);
+		}
+
+		std::array<PyMethodDef, 4> ArchiveFinderMethods = {{
+			{ "find_spec", reinterpret_cast<PyCFunction>(&ArchiveFinderFindSpec), METH_FASTCALL, nullptr },
+			{ "create_module", &ArchiveFinderCreateModule, METH_O, nullptr },
+			{ "exec_module", &ArchiveFinderExecModule, METH_O, nullptr },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		PyModuleDef ArchiveFinderModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify.archive",
+			"Import hook loading code from memory mapped archives",
+			-1,
+			ArchiveFinderMethods.data()
+		};
+
+		// sys.meta_path finder and loader for plugify.pps.<plugin> modules
+		PyObject* PpsFinderFindSpec(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+			if (nargs < 1 || !PyUnicode_Check(args[0])) {
+				PyErr_SetString(PyExc_TypeError, "find_spec expects module name");
 				return nullptr;
 			}
+			Py_ssize_t size = 0;
+			const char* const name = PyUnicode_AsUTF8AndSize(args[0], &size);
+			if (!name) {
+				return nullptr;
+			}
+			constexpr std::string_view prefix = "plugify.pps.";
+			const std::string_view fullName(name, static_cast<size_t>(size));
+			if (!fullName.starts_with(prefix) || fullName.size() == prefix.size() || fullName.find('.', prefix.size()) != std::string_view::npos) {
+				Py_RETURN_NONE;
+			}
+			return g_py3lm.FindModuleSpec(args[0], fullName.substr(prefix.size()), self);
+		}
 
-			g_py3lm.GetProvider()->Log(PyUnicode_AsString(message), plugify::Severity::None);
+		PyObject* PpsFinderCreateModule(PyObject* self, PyObject* spec) {
+			return PyObject_GetAttrString(spec, "loader_state");
+		}
 
-			Py_DECREF(message);
+		PyObject* PpsFinderExecModule(PyObject* self, PyObject* module) {
 			Py_RETURN_NONE;
 		}
+
+		std::array<PyMethodDef, 4> PpsFinderMethods = {{
+			{ "find_spec", reinterpret_cast<PyCFunction>(&PpsFinderFindSpec), METH_FASTCALL, nullptr },
+			{ "create_module", &PpsFinderCreateModule, METH_O, nullptr },
+			{ "exec_module", &PpsFinderExecModule, METH_O, nullptr },
+			{ nullptr, nullptr, 0, nullptr }
+		}};
+
+		PyModuleDef PpsFinderModuleDef = {
+			PyModuleDef_HEAD_INIT,
+			"plugify.pps_finder",
+			"Import hook creating plugin modules on demand",
+			-1,
+			PpsFinderMethods.data()
+		};
+
+		// Bound to address of module dict instead of dict itself, so function and dict don't form a cycle
+		PyObject* LazyEnumGetAttr(PyObject* moduleKey, PyObject* name) {
+			return g_py3lm.FindLazyEnum(static_cast<PyObject*>(PyLong_AsVoidPtr(moduleKey)), name);
+		}
+
+		// Register as submodule of plugify package, so both import forms work
+		bool AddSubmodule(PyObject* package, PyModuleDef& def, const char* name) {
+			PyObject* const module = PyModule_Create(&def);
+			if (!module) {
+				return false;
+			}
+			const bool result = PyDict_SetItemString(PyImport_GetModuleDict(), def.m_name, module) == 0
+				&& PyObject_SetAttrString(package, name, module) == 0;
+			Py_DECREF(module);
+			return result;
+		}
 	}
 
 	Python3LanguageModule::Python3LanguageModule() = default;
@@ -3076,6 +4784,9 @@ namespace py3lm {
 			return ErrorData{ "Provider not exposed" };
 		}
 
+		const auto initStart = std::chrono::steady_clock::now();
+		const size_t initMemory = GetResidentMemorySize();
+
 		_jitRuntime = std::make_shared<asmjit::JitRuntime>();
 
 		std::error_code ec;
@@ -3104,6 +4815,18 @@ namespace py3lm {
 			return ErrorData{ "Python already initialized" };
 		}
 
+		// Plugin directories can be read-only, keep bytecode in writable data or module directory
+		const auto pycachePath = FindWritableDirectory({
+			fs::weakly_canonical(moduleBasePath / ".." / ".." / "data" / "python3.12" / "pycache", ec),
+			moduleBasePath / "pycache"
+		});
+
+		// Inittab is kept between interpreter restarts
+		static const bool coreRegistered = PyImport_AppendInittab("plugify._core", &InitCoreModule) == 0;
+		if (!coreRegistered) {
+			return ErrorData{ "Failed to register plugify._core builtin module" };
+		}
+
 		PyStatus status;
 
 		PyConfig config{};
@@ -3140,6 +4863,13 @@ namespace py3lm {
 				break;
 			}
 
+			if (pycachePath) {
+				status = PyConfig_SetString(&config, &config.pycache_prefix, pycachePath->wstring().c_str());
+				if (PyStatus_Exception(status)) {
+					break;
+				}
+			}
+
 			status = Py_InitializeFromConfig(&config);
 
 			break;
@@ -3149,65 +4879,57 @@ namespace py3lm {
 			return ErrorData{ std::format("Failed to init python: {}", status.err_msg) };
 		}
 
-		PyObject* const plugifyPluginModuleName = PyUnicode_DecodeFSDefault("plugify.plugin");
-		if (!plugifyPluginModuleName) {
-			LogError();
-			return ErrorData{ "Failed to allocate plugify.plugin module string" };
+		if (pycachePath) {
+			_provider->Log(std::format(LOG_PREFIX "Bytecode cache directory '{}'", pycachePath->string()), Severity::Verbose);
+		} else {
+			_provider->Log(LOG_PREFIX "No writable bytecode cache directory, plugins compiled on each start", Severity::Warning);
 		}
 
-		PyObject* const plugifyPluginModule = PyImport_Import(plugifyPluginModuleName);
-		Py_DECREF(plugifyPluginModuleName);
-		if (!plugifyPluginModule) {
+		PyObject* const coreModule = PyImport_ImportModule("plugify._core");
+		if (!coreModule) {
 			LogError();
-			return ErrorData{ "Failed to import plugify.plugin python module" };
+			return ErrorData{ "Failed to import plugify._core python module" };
 		}
 
-		_PluginTypeObject = PyObject_GetAttrString(plugifyPluginModule, "Plugin");
+		_PluginTypeObject = PyObject_GetAttrString(coreModule, "Plugin");
 		if (!_PluginTypeObject) {
-			Py_DECREF(plugifyPluginModule);
+			Py_DECREF(coreModule);
 			LogError();
-			return ErrorData{ "Failed to find plugify.plugin.Plugin type" };
+			return ErrorData{ "Failed to find plugify._core.Plugin type" };
 		}
-		_PluginInfoTypeObject = PyObject_GetAttrString(plugifyPluginModule, "PluginInfo");
+		_PluginInfoTypeObject = PyObject_GetAttrString(coreModule, "PluginInfo");
 		if (!_PluginInfoTypeObject) {
-			Py_DECREF(plugifyPluginModule);
+			Py_DECREF(coreModule);
 			LogError();
-			return ErrorData{ "Failed to find plugify.plugin.PluginInfo type" };
+			return ErrorData{ "Failed to find plugify._core.PluginInfo type" };
 		}
 
-		_Vector2TypeObject = PyObject_GetAttrString(plugifyPluginModule, "Vector2");
+		_Vector2TypeObject = PyObject_GetAttrString(coreModule, "Vector2");
 		if (!_Vector2TypeObject) {
-			Py_DECREF(plugifyPluginModule);
+			Py_DECREF(coreModule);
 			LogError();
-			return ErrorData{ "Failed to find plugify.plugin.Vector2 type" };
+			return ErrorData{ "Failed to find plugify._core.Vector2 type" };
 		}
-		_Vector3TypeObject = PyObject_GetAttrString(plugifyPluginModule, "Vector3");
+		_Vector3TypeObject = PyObject_GetAttrString(coreModule, "Vector3");
 		if (!_Vector3TypeObject) {
-			Py_DECREF(plugifyPluginModule);
+			Py_DECREF(coreModule);
 			LogError();
-			return ErrorData{ "Failed to find plugify.plugin.Vector3 type" };
+			return ErrorData{ "Failed to find plugify._core.Vector3 type" };
 		}
-		_Vector4TypeObject = PyObject_GetAttrString(plugifyPluginModule, "Vector4");
+		_Vector4TypeObject = PyObject_GetAttrString(coreModule, "Vector4");
 		if (!_Vector4TypeObject) {
-			Py_DECREF(plugifyPluginModule);
+			Py_DECREF(coreModule);
 			LogError();
-			return ErrorData{ "Failed to find plugify.plugin.Vector4 type" };
+			return ErrorData{ "Failed to find plugify._core.Vector4 type" };
 		}
-		_Matrix4x4TypeObject = PyObject_GetAttrString(plugifyPluginModule, "Matrix4x4");
+		_Matrix4x4TypeObject = PyObject_GetAttrString(coreModule, "Matrix4x4");
 		if (!_Matrix4x4TypeObject) {
-			Py_DECREF(plugifyPluginModule);
-			LogError();
-			return ErrorData{ "Failed to find plugify.plugin.Matrix4x4 type" };
-		}
-
-		_ExtractRequiredModulesObject = PyObject_GetAttrString(plugifyPluginModule, "extract_required_modules");
-		if (!_ExtractRequiredModulesObject || !PyCallable_Check(_ExtractRequiredModulesObject)) {
-			Py_DECREF(plugifyPluginModule);
+			Py_DECREF(coreModule);
 			LogError();
-			return ErrorData{ "Failed to find plugify.plugin.extract_required_modules function" };
+			return ErrorData{ "Failed to find plugify._core.Matrix4x4 type" };
 		}
 
-		Py_DECREF(plugifyPluginModule);
+		Py_DECREF(coreModule);
 
 		_ppsModule = PyImport_ImportModule("plugify.pps");
 		if (!_ppsModule) {
@@ -3215,12 +4937,55 @@ namespace py3lm {
 			return ErrorData{ "Failed to import plugify.pps python module" };
 		}
 
-		_enumModule = PyImport_ImportModule("enum");
-		if (!_enumModule) {
+		// Bootstrap importlib is always loaded, avoid importing importlib.machinery
+		PyObject* const bootstrapModule = PyImport_ImportModule("_frozen_importlib");
+		if (!bootstrapModule) {
+			LogError();
+			return ErrorData{ "Failed to import _frozen_importlib python module" };
+		}
+
+		_ModuleSpecTypeObject = PyObject_GetAttrString(bootstrapModule, "ModuleSpec");
+		Py_DECREF(bootstrapModule);
+		if (!_ModuleSpecTypeObject) {
+			LogError();
+			return ErrorData{ "Failed to find ModuleSpec type" };
+		}
+
+		PyObject* const bootstrapExternalModule = PyImport_ImportModule("_frozen_importlib_external");
+		if (!bootstrapExternalModule) {
+			LogError();
+			return ErrorData{ "Failed to import _frozen_importlib_external python module" };
+		}
+
+		_cacheFromSourceObject = PyObject_GetAttrString(bootstrapExternalModule, "cache_from_source");
+		Py_DECREF(bootstrapExternalModule);
+		if (!_cacheFromSourceObject) {
+			LogError();
+			return ErrorData{ "Failed to find cache_from_source function" };
+		}
+
+		// Deployments opt in at startup, e.g. after plugins were updated
+		if (const char* const precompile = std::getenv("PY3LM_PRECOMPILE_PLUGINS"); precompile && std::string_view(precompile) == "1") {
+			PrecompilePlugins(pluginsPath);
+		}
+
+		// Plugin modules are created when first imported instead of scanning plugin sources for imports
+		_ppsFinder = PyModule_Create(&PpsFinderModuleDef);
+		PyObject* const metaPath = PySys_GetObject("meta_path");
+		if (!_ppsFinder || !metaPath || PyList_Insert(metaPath, 0, _ppsFinder) < 0) {
+			LogError();
+			return ErrorData{ "Failed to register plugify.pps module finder" };
+		}
+
+		_archiveFinder = PyModule_Create(&ArchiveFinderModuleDef);
+		if (!_archiveFinder || !InsertIntoMetaPath(metaPath, _archiveFinder)) {
 			LogError();
-			return ErrorData{ "Failed to import enum python module" };
+			return ErrorData{ "Failed to register archive module finder" };
 		}
 
+		// Modules imported during interpreter init still come from python312.zip
+		MountArchive(pythonBasePath / "python312.pyar");
+
 		PyObject* const builtinsModule = PyImport_ImportModule("builtins");
 		if (!builtinsModule) {
 			LogError();
@@ -3243,19 +5008,63 @@ namespace py3lm {
 		Py_DECREF(customPrintFunc);
 		Py_DECREF(builtinsModule);
 
-		PyObject* const tracebackModule = PyImport_ImportModule("traceback");
-		if (!tracebackModule) {
+		PyObject* const plugifyModule = PyImport_ImportModule("plugify");
+		if (!plugifyModule) {
 			LogError();
-			return ErrorData{ "Failed to import traceback python module" };
+			return ErrorData{ "Failed to import plugify python package" };
 		}
-		_formatException = PyObject_GetAttrString(tracebackModule, "format_exception");
-		if (!_formatException) {
-			Py_DECREF(tracebackModule);
+
+		if (!AddSubmodule(plugifyModule, TimersModuleDef, "timers")) {
+			Py_DECREF(plugifyModule);
+			LogError();
+			return ErrorData{ "Failed to register plugify.timers python module" };
+		}
+
+		if (!AddSubmodule(plugifyModule, AioModuleDef, "_aio")) {
+			Py_DECREF(plugifyModule);
+			LogError();
+			return ErrorData{ "Failed to register plugify._aio python module" };
+		}
+
+		// Set while code of a plugin runs and inherited by its tasks, so work started by a plugin can be cancelled when it ends
+		_pluginContextVar = PyContextVar_New("plugify_plugin", nullptr);
+		if (!_pluginContextVar || PyModule_AddObjectRef(PyDict_GetItemString(PyImport_GetModuleDict(), "plugify._aio"), "current_plugin", _pluginContextVar) != 0) {
+			Py_DECREF(plugifyModule);
+			LogError();
+			return ErrorData{ "Failed to create plugin context variable" };
+		}
+
+		if (!AddSubmodule(plugifyModule, CollectorModuleDef, "collector")) {
+			Py_DECREF(plugifyModule);
+			LogError();
+			return ErrorData{ "Failed to register plugify.collector python module" };
+		}
+
+		if (!AddSubmodule(plugifyModule, StringsModuleDef, "strings")) {
+			Py_DECREF(plugifyModule);
+			LogError();
+			return ErrorData{ "Failed to register plugify.strings python module" };
+		}
+
+		if (!AddSubmodule(plugifyModule, ArraysModuleDef, "arrays")) {
+			Py_DECREF(plugifyModule);
+			LogError();
+			return ErrorData{ "Failed to register plugify.arrays python module" };
+		}
+
+		if (!AddSubmodule(plugifyModule, HandlesModuleDef, "handles")) {
+			Py_DECREF(plugifyModule);
+			LogError();
+			return ErrorData{ "Failed to register plugify.handles python module" };
+		}
+
+		if (!AddSubmodule(plugifyModule, RefsModuleDef, "refs")) {
+			Py_DECREF(plugifyModule);
 			LogError();
-			return ErrorData{ "Failed to import traceback.format_exception python module" };
+			return ErrorData{ "Failed to register plugify.refs python module" };
 		}
 
-		Py_DECREF(tracebackModule);
+		Py_DECREF(plugifyModule);
 
 		_typeMap.try_emplace(&PyType_Type, PyAbstractType::Type, "Type");
 		_typeMap.try_emplace(&PyBaseObject_Type, PyAbstractType::BaseObject, "BaseObject");
@@ -3323,16 +5132,62 @@ namespace py3lm {
 		_typeMap.try_emplace(&PyMemberDescr_Type, PyAbstractType::MemberDescr, "MemberDescr");
 		_typeMap.try_emplace(&PySuper_Type, PyAbstractType::Super, "Super");
 
-		_typeMap.try_emplace(Py_TYPE(_Vector2TypeObject), PyAbstractType::Vector2, "Vector2");
-		_typeMap.try_emplace(Py_TYPE(_Vector3TypeObject), PyAbstractType::Vector3, "Vector3");
-		_typeMap.try_emplace(Py_TYPE(_Vector4TypeObject), PyAbstractType::Vector4, "Vector4");
-		_typeMap.try_emplace(Py_TYPE(_Matrix4x4TypeObject), PyAbstractType::Matrix4x4, "Matrix4x4");
+		_typeMap.try_emplace(reinterpret_cast<PyTypeObject*>(_Vector2TypeObject), PyAbstractType::Vector2, "Vector2");
+		_typeMap.try_emplace(reinterpret_cast<PyTypeObject*>(_Vector3TypeObject), PyAbstractType::Vector3, "Vector3");
+		_typeMap.try_emplace(reinterpret_cast<PyTypeObject*>(_Vector4TypeObject), PyAbstractType::Vector4, "Vector4");
+		_typeMap.try_emplace(reinterpret_cast<PyTypeObject*>(_Matrix4x4TypeObject), PyAbstractType::Matrix4x4, "Matrix4x4");
 
-		return InitResultData{{ .hasUpdate = false }};
+		// enum and traceback are imported on first use
+		const std::chrono::duration<double, std::milli> initTime = std::chrono::steady_clock::now() - initStart;
+		const size_t residentMemory = GetResidentMemorySize();
+		_provider->Log(std::format(LOG_PREFIX "Initialized in {:.3f} ms, {} python modules imported, resident memory +{} KiB",
+								   initTime.count(), PyDict_Size(PyImport_GetModuleDict()), (residentMemory > initMemory ? residentMemory - initMemory : 0) / 1024), Severity::Verbose);
+
+		return InitResultData{{ .hasUpdate = true }};
 	}
 
 	void Python3LanguageModule::Shutdown() {
 		if (Py_IsInitialized()) {
+			if (_deltaTimeObject) {
+				Py_DECREF(_deltaTimeObject);
+			}
+
+			for (auto& data : _updatePlugins) {
+				Py_XDECREF(data.task);
+			}
+			_startedUpdatePlugins.clear();
+
+			_timers.Clear([](void* data) {
+				auto* const timer = static_cast<TimerData*>(data);
+				Py_DECREF(timer->callback);
+				delete timer;
+			});
+
+			Py_XDECREF(_collector.collect);
+			Py_XDECREF(_collector.getCount);
+			Py_XDECREF(_collector.freeze);
+
+			_stringCache.Configure(0, 0);
+			_handles.Clear();
+
+			if (_aioModule) {
+				if (PyObject* const returnObject = PyObject_CallNoArgs(_aioClose)) {
+					Py_DECREF(returnObject);
+				} else {
+					LogError();
+				}
+				Py_DECREF(_aioStep);
+				Py_DECREF(_aioCreateTask);
+				Py_DECREF(_aioClose);
+				Py_DECREF(_aioCancelPlugin);
+				Py_DECREF(_aioModule);
+			}
+
+			for (const auto& [_, pluginId] : _pluginIds) {
+				Py_DECREF(pluginId);
+			}
+			Py_XDECREF(_pluginContextVar);
+
 			if (_formatException) {
 				Py_DECREF(_formatException);
 			}
@@ -3341,6 +5196,24 @@ namespace py3lm {
 				Py_DECREF(_enumModule);
 			}
 
+			if (_ppsFinder) {
+				RemoveFromMetaPath(_ppsFinder);
+				Py_DECREF(_ppsFinder);
+			}
+
+			if (_archiveFinder) {
+				RemoveFromMetaPath(_archiveFinder);
+				Py_DECREF(_archiveFinder);
+			}
+
+			if (_ModuleSpecTypeObject) {
+				Py_DECREF(_ModuleSpecTypeObject);
+			}
+
+			if (_cacheFromSourceObject) {
+				Py_DECREF(_cacheFromSourceObject);
+			}
+
 			if (_ppsModule) {
 				if (PyObject* const moduleDict = PyModule_GetDict(_ppsModule)) {
 					PyDict_Clear(moduleDict);
@@ -3364,9 +5237,6 @@ namespace py3lm {
 				Py_DECREF(_Matrix4x4TypeObject);
 			}
 
-			if (_ExtractRequiredModulesObject) {
-				Py_DECREF(_ExtractRequiredModulesObject);
-			}
 
 			if (_PluginTypeObject) {
 				Py_DECREF(_PluginTypeObject);
@@ -3388,8 +5258,16 @@ namespace py3lm {
 				Py_DECREF(data.pythonFunction);
 			}
 
-			for (const auto& [object, _] : _internalEnumMap) {
-				Py_DECREF(object);
+			for (const auto& data : _enums) {
+				if (data->type) {
+					data->members.ForEach([](PyObject* object) { Py_DECREF(object); });
+					Py_DECREF(data->type);
+				}
+			}
+
+			for (const auto& [moduleDict, moduleEnums] : _moduleEnumMap) {
+				Py_XDECREF(moduleEnums.getattr);
+				Py_DECREF(moduleDict);
 			}
 
 			for (const auto& [_, pluginData] : _pluginsMap) {
@@ -3400,12 +5278,27 @@ namespace py3lm {
 			Py_Finalize();
 		}
 		_formatException = nullptr;
+		_deltaTimeObject = nullptr;
+		_deltaTime = 0.0;
+		_timerTicks = 0.0;
+		_collector = {};
+		_aioModule = nullptr;
+		_aioStep = nullptr;
+		_aioCreateTask = nullptr;
+		_aioClose = nullptr;
+		_aioCancelPlugin = nullptr;
+		_pluginContextVar = nullptr;
+		_pluginIds.clear();
 		_ppsModule = nullptr;
+		_ppsFinder = nullptr;
+		_archiveFinder = nullptr;
+		_archives.clear();
+		_ModuleSpecTypeObject = nullptr;
+		_cacheFromSourceObject = nullptr;
 		_Vector2TypeObject = nullptr;
 		_Vector3TypeObject = nullptr;
 		_Vector4TypeObject = nullptr;
 		_Matrix4x4TypeObject = nullptr;
-		_ExtractRequiredModulesObject = nullptr;
 		_PluginTypeObject = nullptr;
 		_PluginInfoTypeObject = nullptr;
 		_internalMap.clear();
@@ -3413,11 +5306,16 @@ namespace py3lm {
 		_internalFunctions.clear();
 		_externalFunctions.clear();
 		_externalEnumMap.clear();
-		_internalEnumMap.clear();
+		_moduleEnumMap.clear();
+		_enums.clear();
 		_moduleMethods.clear();
 		_moduleFunctions.clear();
 		_pythonMethods.clear();
+		_callbackOptions.clear();
 		_pluginsMap.clear();
+		_updatePlugins.clear();
+		_updateFrame = 0;
+		_updatePhase = 0;
 		_jitRuntime.reset();
 		_provider.reset();
 	}
@@ -3449,48 +5347,189 @@ namespace py3lm {
 		TryCreateModule(plugin, true);
 	}
 
-	void Python3LanguageModule::ResolveRequiredModule(std::string_view moduleName) {
-		if (moduleName.starts_with("plugify.pps.") && moduleName.size() > 12) {
-			std::string_view pluginName = moduleName.substr(12);
-			if (const auto pos = pluginName.find('.'); pos != std::string::npos) {
-				pluginName = pluginName.substr(0, pos);
+	const Archive* Python3LanguageModule::MountArchive(const fs::path& archivePath) {
+		std::error_code ec;
+		if (!fs::is_regular_file(archivePath, ec)) {
+			return nullptr;
+		}
+
+		// Plugin archives are looked up on every load, including reloads of the same plugin
+		for (const auto& archive : _archives) {
+			if (archive->GetPath() == archivePath) {
+				return archive.get();
+			}
+		}
+
+		auto archive = Archive::Open(archivePath, static_cast<uint32_t>(PyImport_GetMagicNumber()));
+		if (!archive) {
+			_provider->Log(std::format(LOG_PREFIX "Archive '{}' is corrupted or built for other python version", archivePath.string()), Severity::Warning);
+			return nullptr;
+		}
+
+		_provider->Log(std::format(LOG_PREFIX "Mounted archive '{}'", archivePath.string()), Severity::Verbose);
+		return _archives.emplace_back(std::move(archive)).get();
+	}
+
+	PyObject* Python3LanguageModule::FindArchiveSpec(PyObject* fullName, PyObject* loader) {
+		Py_ssize_t size = 0;
+		const char* const name = PyUnicode_AsUTF8AndSize(fullName, &size);
+		if (!name) {
+			return nullptr;
+		}
+		const std::string_view moduleName(name, static_cast<size_t>(size));
+
+		for (const auto& archive : _archives) {
+			const auto module = archive->Find(moduleName);
+			if (!module) {
+				continue;
 			}
-			PluginHandle plugin = _provider->FindPlugin(pluginName);
-			if (plugin && plugin.GetState() == PluginState::Loaded) {
-				TryCreateModule(plugin, false);
-			} else {
-				PyObject* const moduleDict = PyModule_GetDict(_ppsModule);
-				PyObject* const moduleObject = PyModule_New(pluginName.data());
-				assert(PyDict_SetItemString(moduleDict, pluginName.data(), moduleObject) == 0);
-				Py_DECREF(moduleObject);
+
+			std::string relativePath(moduleName);
+			ReplaceAll(relativePath, ".", "/");
+			const std::u8string archivePath = archive->GetPath().u8string();
+			const std::string origin = std::format("{}/{}{}", std::string_view(reinterpret_cast<const char*>(archivePath.data()), archivePath.size()), relativePath, module->package ? "/__init__.py" : ".py");
+
+			PyObject* const args = PyTuple_Pack(2, fullName, loader);
+			if (!args) {
+				return nullptr;
+			}
+			PyObject* const kwargs = Py_BuildValue("{s:s,s:O}", "origin", origin.c_str(), "is_package", module->package ? Py_True : Py_False);
+			if (!kwargs) {
+				Py_DECREF(args);
+				return nullptr;
+			}
+			PyObject* const spec = PyObject_Call(_ModuleSpecTypeObject, args, kwargs);
+			Py_DECREF(kwargs);
+			Py_DECREF(args);
+			// Sets __file__ from origin
+			if (spec && PyObject_SetAttrString(spec, "has_location", Py_True) < 0) {
+				Py_DECREF(spec);
+				return nullptr;
+			}
+			return spec;
+		}
+
+		Py_RETURN_NONE;
+	}
+
+	PyObject* Python3LanguageModule::ExecArchiveModule(PyObject* module) {
+		const char* const name = PyModule_GetName(module);
+		if (!name) {
+			return nullptr;
+		}
+
+		for (const auto& archive : _archives) {
+			const auto archiveModule = archive->Find(name);
+			if (!archiveModule) {
+				continue;
 			}
+
+			// Unmarshal straight from mapped pages
+			PyObject* const code = PyMarshal_ReadObjectFromString(archiveModule->code.data(), static_cast<Py_ssize_t>(archiveModule->code.size()));
+			if (!code) {
+				return nullptr;
+			}
+			PyObject* const moduleDict = PyModule_GetDict(module);
+			PyObject* const result = PyEval_EvalCode(code, moduleDict, moduleDict);
+			Py_DECREF(code);
+			if (!result) {
+				return nullptr;
+			}
+			Py_DECREF(result);
+			Py_RETURN_NONE;
+		}
+
+		PyErr_Format(PyExc_ImportError, "Module '%s' not found in archives", name);
+		return nullptr;
+	}
+
+	void Python3LanguageModule::PrecompilePlugins(const fs::path& pluginsPath) {
+		PyObject* const compileallModule = PyImport_ImportModule("compileall");
+		if (!compileallModule) {
+			LogError();
+			return;
 		}
+
+		PyObject* const compileDir = PyObject_GetAttrString(compileallModule, "compile_dir");
+		Py_DECREF(compileallModule);
+		if (!compileDir) {
+			LogError();
+			return;
+		}
+
+		const std::u8string pluginsString = pluginsPath.u8string();
+		PyObject* const args = Py_BuildValue("(N)", PyUnicode_FromStringAndSize(reinterpret_cast<const char*>(pluginsString.data()), static_cast<Py_ssize_t>(pluginsString.size())));
+		// Single worker, process pool would spawn host executable
+		PyObject* const kwargs = Py_BuildValue("{s:i,s:i}", "quiet", 1, "workers", 1);
+		if (!args || !kwargs) {
+			Py_XDECREF(args);
+			Py_XDECREF(kwargs);
+			Py_DECREF(compileDir);
+			LogError();
+			return;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		PyObject* const result = PyObject_Call(compileDir, args, kwargs);
+		const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+		Py_DECREF(kwargs);
+		Py_DECREF(args);
+		Py_DECREF(compileDir);
+
+		if (!result) {
+			LogError();
+			return;
+		}
+
+		_provider->Log(std::format(LOG_PREFIX "Precompiled plugins in {:.3f} ms{}", duration.count(), PyObject_IsTrue(result) ? "" : " with errors"), Severity::Verbose);
+		Py_DECREF(result);
 	}
 
-	std::vector<std::string> Python3LanguageModule::ExtractRequiredModules(const std::string& modulePath) {
-		std::vector<std::string> requiredModules;
-		PyObject* const result = PyObject_CallOneArg(_ExtractRequiredModulesObject, PyUnicode_FromString(modulePath.c_str()));
+	PyObject* Python3LanguageModule::ResolveRequiredModule(const std::string& pluginName) {
+		PluginHandle plugin = _provider->FindPlugin(pluginName);
+		if (plugin && plugin.GetState() == PluginState::Loaded) {
+			TryCreateModule(plugin, false);
+		}
 
-		if (result) {
-			if (PySet_Check(result)) {
-				PyObject* iterator = PyObject_GetIter(result);
-				PyObject* object;
+		PyObject* const moduleDict = PyModule_GetDict(_ppsModule);
+		if (PyObject* const moduleObject = PyDict_GetItemString(moduleDict, pluginName.c_str())) {
+			return moduleObject;
+		}
 
-				while ((object = PyIter_Next(iterator))) {
-					std::string_view moduleName = PyUnicode_AsString(object);
-					if (!moduleName.empty()) {
-						requiredModules.emplace_back(moduleName);
-					}
-					Py_DECREF(object);
-				}
-				Py_DECREF(iterator);
-			}
-			Py_DECREF(result);
-		} else {
-			LogError();
+		// Plugin is not loaded yet, methods are added on export
+		PyObject* const moduleObject = PyModule_New(pluginName.c_str());
+		if (!moduleObject) {
+			return nullptr;
+		}
+		const int result = PyDict_SetItemString(moduleDict, pluginName.c_str(), moduleObject);
+		Py_DECREF(moduleObject);
+		return result == 0 ? moduleObject : nullptr;
+	}
+
+	PyObject* Python3LanguageModule::FindModuleSpec(PyObject* fullName, std::string_view pluginName, PyObject* loader) {
+		const std::string name(pluginName);
+		// Unknown plugins are left to other finders, so their import raises ModuleNotFoundError
+		if (!_provider->FindPlugin(name) && !PyDict_GetItemString(PyModule_GetDict(_ppsModule), name.c_str())) {
+			Py_RETURN_NONE;
+		}
+		PyObject* const moduleObject = ResolveRequiredModule(name);
+		if (!moduleObject) {
+			return nullptr;
 		}
 
-		return requiredModules;
+		PyObject* const args = PyTuple_Pack(2, fullName, loader);
+		if (!args) {
+			return nullptr;
+		}
+		PyObject* const kwargs = Py_BuildValue("{s:s,s:O}", "origin", "plugify", "loader_state", moduleObject);
+		if (!kwargs) {
+			Py_DECREF(args);
+			return nullptr;
+		}
+		PyObject* const spec = PyObject_Call(_ModuleSpecTypeObject, args, kwargs);
+		Py_DECREF(kwargs);
+		Py_DECREF(args);
+		return spec;
 	}
 
 	LoadResult Python3LanguageModule::OnPluginLoad(PluginHandle plugin) {
@@ -3521,29 +5560,44 @@ namespace py3lm {
 		filePathRelative.replace_extension(".py");
 		const fs::path filePath = baseFolder / filePathRelative;
 		std::error_code ec;
-		if (!fs::exists(filePath, ec) || !fs::is_regular_file(filePath, ec)) {
-			return ErrorData{ std::format("Module file '{}' not exist", filePath.string()) };
-		}
+		const bool fileExists = fs::exists(filePath, ec) && fs::is_regular_file(filePath, ec);
 		const fs::path pluginsFolder = baseFolder.parent_path();
 		filePathRelative = fs::relative(filePath, pluginsFolder, ec);
 		filePathRelative.replace_extension();
 		std::string moduleName = filePathRelative.generic_string();
 		ReplaceAll(moduleName, "/", ".");
 
-		_provider->Log(std::format(LOG_PREFIX "Load plugin module '{}'", moduleName), Severity::Verbose);
-
 		GILLock lock{};
 
-		for (const auto& requiredModule : ExtractRequiredModules(filePath.string())) {
-			ResolveRequiredModule(requiredModule);
+		PyObject* const pluginId = GetPluginIdObject(plugin.GetId());
+		if (!pluginId) {
+			LogError();
+			return ErrorData{ "Failed to create plugin id object" };
+		}
+		// Module level code and constructor already run as code of the plugin
+		PluginContextScope pluginContext(pluginId);
+
+		// Plugin can ship its modules as <name>.pyar archive instead of loose files
+		const Archive* const archive = MountArchive(baseFolder / std::format("{}.pyar", plugin.GetName()));
+		const bool archived = archive && archive->Find(moduleName);
+		if (!fileExists && !archived) {
+			return ErrorData{ std::format("Module file '{}' not exist", filePath.string()) };
 		}
 
+		_provider->Log(std::format(LOG_PREFIX "Load plugin module '{}'", moduleName), Severity::Verbose);
+
+		const bool bytecodeCached = !archived && IsBytecodeCached(_cacheFromSourceObject, filePath);
+		const auto importStart = std::chrono::steady_clock::now();
+
 		PyObject* const pluginModule = PyImport_ImportModule(moduleName.c_str());
 		if (!pluginModule) {
 			LogError();
 			return ErrorData{ std::format("Failed to import '{}' module", moduleName) };
 		}
 
+		const std::chrono::duration<double, std::milli> importTime = std::chrono::steady_clock::now() - importStart;
+		_provider->Log(std::format(LOG_PREFIX "Imported plugin module '{}' in {:.3f} ms ({})", moduleName, importTime.count(), archived ? "archive" : bytecodeCached ? "bytecode cache hit" : "compiled"), Severity::Verbose);
+
 		PyObject* const classNameString = PyUnicode_FromStringAndSize(className.data(), static_cast<Py_ssize_t>(className.size()));
 		if (!classNameString) {
 			Py_DECREF(pluginModule);
@@ -3650,7 +5704,7 @@ namespace py3lm {
 		if (!exportedMethods.empty()) {
 			PyObject* const pluginDict = PyModule_GetDict(pluginModule);
 			for (const MethodHandle method : exportedMethods) {
-				MethodExportResult generateResult = GenerateMethodExport(method, _jitRuntime, pluginDict, pluginInstance);
+				MethodExportResult generateResult = GenerateMethodExport(method, _jitRuntime, pluginDict, pluginInstance, pluginId);
 				if (auto* data = std::get_if<MethodExportError>(&generateResult)) {
 					exportErrors.emplace_back(std::move(*data));
 					continue;
@@ -3660,84 +5714,682 @@ namespace py3lm {
 			}
 		}
 
-		PyObject* updatePlugin = PyObject_GetAttrString(pluginInstance, "plugin_update");
-		if (!updatePlugin) {
-			PyErr_Clear();
-		} else if (!PyFunction_Check(updatePlugin) && !PyCallable_Check(updatePlugin)) {
-			exportErrors.emplace_back("plugin_update");
+		PyObject* updatePlugin = PyObject_GetAttrString(pluginInstance, "plugin_update");
+		if (!updatePlugin) {
+			PyErr_Clear();
+		} else if (!PyFunction_Check(updatePlugin) && !PyCallable_Check(updatePlugin)) {
+			exportErrors.emplace_back("plugin_update");
+		}
+
+		PyObject* startPlugin = PyObject_GetAttrString(pluginInstance, "plugin_start");
+		if (!startPlugin) {
+			PyErr_Clear();
+		} else if (!PyFunction_Check(startPlugin) && !PyCallable_Check(startPlugin)) {
+			exportErrors.emplace_back("plugin_start");
+		}
+
+		PyObject* endPlugin = PyObject_GetAttrString(pluginInstance, "plugin_end");
+		if (!endPlugin) {
+			PyErr_Clear();
+		} else if (!PyFunction_Check(endPlugin) && !PyCallable_Check(endPlugin)) {
+			exportErrors.emplace_back("plugin_end");
+		}
+
+		if (!exportErrors.empty()) {
+			Py_DECREF(pluginInstance);
+			Py_DECREF(pluginModule);
+			std::string errorString("Methods export error(s): " + exportErrors[0]);
+			for (auto it = std::next(exportErrors.begin()); it != exportErrors.end(); ++it) {
+				std::format_to(std::back_inserter(errorString), ", {}", *it);
+			}
+			return ErrorData{ std::move(errorString) };
+		}
+
+		const auto [it, result] = _pluginsMap.try_emplace(plugin.GetId(), pluginModule, pluginInstance, updatePlugin, startPlugin, endPlugin, pluginId);
+		if (!result) {
+			Py_DECREF(pluginInstance);
+			Py_DECREF(pluginModule);
+			return ErrorData{ std::format("Save plugin data to map unsuccessful") };
+		}
+
+		std::vector<MethodData> methods;
+		methods.reserve(methodsHolders.size());
+		_pythonMethods.reserve(methodsHolders.size());
+
+		for (auto& [method, methodData] : methodsHolders) {
+			const MemAddr methodAddr = methodData.jitCallback.GetFunction();
+			methods.emplace_back(method, methodAddr);
+			AddToFunctionsMap(methodAddr, methodData.pythonFunction);
+			_pythonMethods.emplace_back(std::move(methodData));
+		}
+
+		if (_collector.enabled) {
+			_collector.freezePending = true;
+		}
+
+		// plugin_update is dispatched from OnUpdate for all plugins at once, start/end are still required to (un)register it
+		const bool hasUpdate = updatePlugin != nullptr;
+		return LoadResultData{ std::move(methods), &it->second, { false, hasUpdate || startPlugin != nullptr, hasUpdate || endPlugin != nullptr, !exportedMethods.empty() } };
+	}
+
+	void Python3LanguageModule::OnPluginStart(PluginHandle plugin) {
+		auto* const pluginData = plugin.GetData().RCast<PluginData*>();
+		GILLock lock{};
+		PluginContextScope pluginContext(pluginData->id);
+		if (pluginData->start) {
+			PyObject* const returnObject = PyObject_CallNoArgs(pluginData->start);
+			if (!returnObject) {
+				LogError();
+				_provider->Log(std::format(LOG_PREFIX "{}: call of 'plugin_start' failed", plugin.GetName()), Severity::Error);
+			} else {
+				if (PyCoro_CheckExact(returnObject)) {
+					if (PyObject* const task = CreateTask(returnObject)) {
+						Py_DECREF(task);
+					} else {
+						LogError();
+					}
+				}
+				Py_DECREF(returnObject);
+			}
+		}
+		if (pluginData->update) {
+			MarkUpdateBusy();
+			UpdateData data{ plugin, pluginData->update, pluginData->id };
+
+			const auto GetSetting = [&](const char* name) {
+				if (auto value = GetObjectAttrAsNumber(pluginData->instance, name)) {
+					if (std::isfinite(*value) && *value >= 0.0) {
+						return *value;
+					}
+					_provider->Log(std::format(LOG_PREFIX "{}: '{}' should be non-negative number", plugin.GetName(), name), Severity::Warning);
+				} else {
+					LogError();
+				}
+				return 0.0;
+			};
+
+			const double rate = GetSetting("update_rate");
+			const double interval = GetSetting("update_interval");
+			data.budget = GetSetting("update_budget");
+
+			// Low-rate plugins get different phases, so they don't fire together on the same frame
+			const uint32_t phase = _updatePhase++;
+			if (rate > 0.0) {
+				data.period = 1.0 / rate;
+				data.accumulator = data.period * std::fmod(phase * 0.6180339887498949, 1.0);
+			} else if (interval > 1.0) {
+				data.interval = static_cast<uint32_t>(std::min(interval, static_cast<double>(UINT32_MAX)));
+				data.offset = phase % data.interval;
+			}
+
+			// plugin_update may start plugins, they join after the dispatch loop so its entries stay in place
+			(_dispatchingUpdates ? _startedUpdatePlugins : _updatePlugins).push_back(data);
+		}
+	}
+
+	void Python3LanguageModule::OnUpdate(DateTime dt) {
+		// Hosts with idle python plugins don't take the GIL at all, anything scheduling work marks update busy
+		if (_updateIdle.load(std::memory_order_acquire)) {
+			return;
+		}
+
+		GILLock lock{};
+
+		UpdateTimers(dt);
+
+		if (!_updatePlugins.empty()) {
+			UpdatePlugins(dt);
+		}
+
+		StepEventLoop();
+
+		UpdateCollector(dt);
+
+		// Stored under the GIL, so work scheduled by other threads can't be lost between the checks and the store
+		_updateIdle.store(_updatePlugins.empty() && _timers.Count() == 0 && _eventLoopIdle && !_collector.enabled, std::memory_order_release);
+	}
+
+	void Python3LanguageModule::UpdatePlugins(DateTime dt) {
+		// Host usually ticks at a fixed rate, so the same float object can be shared between frames
+		const double deltaTime = static_cast<double>(dt.AsSeconds());
+		if (!_deltaTimeObject || _deltaTime != deltaTime) {
+			PyObject* const deltaTimeObject = PyFloat_FromDouble(deltaTime);
+			if (!deltaTimeObject) {
+				LogError();
+				return;
+			}
+			Py_XDECREF(_deltaTimeObject);
+			_deltaTimeObject = deltaTimeObject;
+			_deltaTime = deltaTime;
+		}
+
+		// Slot before argument allows callee to prepend 'self' without tuple allocation
+		std::array<PyObject*, 2> args{ nullptr, _deltaTimeObject };
+
+		const uint64_t frame = _updateFrame++;
+
+		// Plugins started or ended by plugin_update are added or erased after the loop
+		_dispatchingUpdates = true;
+
+		for (size_t i = 0; i < _updatePlugins.size(); ++i) {
+			UpdateData& data = _updatePlugins[i];
+			if (data.ended) {
+				continue;
+			}
+			data.elapsed += deltaTime;
+
+			if (data.period > 0.0) {
+				data.accumulator += deltaTime;
+				if (data.accumulator < data.period) {
+					continue;
+				}
+			} else if (data.interval > 1 && !data.deferred && (frame + data.offset) % data.interval != 0) {
+				continue;
+			}
+
+			if (data.overrun) {
+				// Defer by one frame after budget overrun, elapsed time still accumulates
+				data.overrun = false;
+				data.deferred = true;
+				continue;
+			}
+			data.deferred = false;
+
+			if (data.task) {
+				if (!IsTaskDone(data.task)) {
+					// Previous async plugin_update still running
+					continue;
+				}
+				Py_CLEAR(data.task);
+			}
+
+			PyObject* elapsedObject = nullptr;
+			if (data.elapsed != deltaTime) {
+				elapsedObject = PyFloat_FromDouble(data.elapsed);
+				if (!elapsedObject) {
+					LogError();
+					continue;
+				}
+				args[1] = elapsedObject;
+			}
+
+			// Async plugin_update task is created in the scope too, so it is cancelled with other tasks of the plugin
+			PluginContextScope pluginContext(data.id);
+
+			// Plugin may be ended and unloaded by its own plugin_update
+			PyObject* const update = Py_NewRef(data.update);
+			const auto start = std::chrono::steady_clock::now();
+			PyObject* const returnObject = PyObject_Vectorcall(update, args.data() + 1, 1 | PY_VECTORCALL_ARGUMENTS_OFFSET, nullptr);
+			const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+			Py_DECREF(update);
+
+			if (elapsedObject) {
+				args[1] = _deltaTimeObject;
+				Py_DECREF(elapsedObject);
+			}
+
+			if (data.ended) {
+				if (!returnObject) {
+					LogError();
+				} else if (PyCoro_CheckExact(returnObject)) {
+					// Never scheduled, close it so it doesn't warn about not being awaited
+					if (PyObject* const result = PyObject_CallMethod(returnObject, "close", nullptr)) {
+						Py_DECREF(result);
+					} else {
+						LogError();
+					}
+				}
+				Py_XDECREF(returnObject);
+				continue;
+			}
+
+			data.elapsed = 0.0;
+			if (data.period > 0.0) {
+				data.accumulator -= data.period;
+				if (data.accumulator >= data.period) {
+					// Fell behind, drop missed calls instead of bursting
+					data.accumulator = 0.0;
+				}
+			}
+			data.overrun = data.budget > 0.0 && duration.count() > data.budget;
+
+			if (!returnObject) {
+				LogError();
+				_provider->Log(std::format(LOG_PREFIX "{}: call of 'plugin_update' failed", data.plugin.GetName()), Severity::Error);
+				continue;
+			}
+			if (PyCoro_CheckExact(returnObject)) {
+				data.task = CreateTask(returnObject);
+				if (!data.task) {
+					LogError();
+				}
+			}
+			Py_DECREF(returnObject);
+		}
+
+		_dispatchingUpdates = false;
+		std::erase_if(_updatePlugins, [](const UpdateData& data) { return data.ended; });
+		_updatePlugins.insert(_updatePlugins.end(), _startedUpdatePlugins.begin(), _startedUpdatePlugins.end());
+		_startedUpdatePlugins.clear();
+	}
+
+	void Python3LanguageModule::UpdateTimers(DateTime dt) {
+		// Timer wheel tick is 1 millisecond
+		_timerTicks += static_cast<double>(dt.AsSeconds()) * 1000.0;
+		const auto ticks = static_cast<uint64_t>(_timerTicks);
+		_timerTicks -= static_cast<double>(ticks);
+
+		_timers.Advance(ticks, [this](void* data, bool repeating) {
+			auto* const timer = static_cast<TimerData*>(data);
+			PyObject* const callback = timer->callback;
+			PluginContextScope pluginContext(timer->plugin);
+			if (repeating) {
+				// Repeating timer keeps its reference and may be cancelled by the callback itself
+				Py_INCREF(callback);
+			} else {
+				delete timer;
+			}
+			PyObject* const returnObject = PyObject_CallNoArgs(callback);
+			if (!returnObject) {
+				LogError();
+				_provider->Log(LOG_PREFIX "Call of timer callback failed", Severity::Error);
+			} else {
+				Py_DECREF(returnObject);
+			}
+			Py_DECREF(callback);
+		});
+	}
+
+	PyObject* Python3LanguageModule::ScheduleTimer(double delay, double interval, PyObject* callback) {
+		if (!PyCallable_Check(callback)) {
+			SetTypeError("Expected callable", callback);
+			return nullptr;
+		}
+		if (!std::isfinite(delay) || !std::isfinite(interval) || delay < 0.0 || interval < 0.0) {
+			PyErr_SetString(PyExc_ValueError, "Time should be non-negative finite number of seconds");
+			return nullptr;
+		}
+		// Timer without owner would never be cancelled and could outlive code it calls
+		PyObject* const plugin = CurrentPlugin();
+		if (!plugin) {
+			PyErr_SetString(PyExc_RuntimeError, "Timers can only be scheduled by plugin code");
+			return nullptr;
+		}
+		Py_INCREF(callback);
+		MarkUpdateBusy();
+		const auto ticks = [](double seconds) { return static_cast<uint64_t>(std::ceil(seconds * 1000.0)); };
+		const TimerWheel::Handle handle = _timers.Schedule(ticks(delay), ticks(interval), new TimerData{ callback, plugin });
+		return PyLong_FromUnsignedLongLong(handle);
+	}
+
+	PyObject* Python3LanguageModule::CancelTimer(PyObject* handle) {
+		if (!PyLong_Check(handle)) {
+			SetTypeError("Expected integer", handle);
+			return nullptr;
+		}
+		const TimerWheel::Handle value = PyLong_AsUnsignedLongLong(handle);
+		if (PyErr_Occurred()) {
+			return nullptr;
+		}
+		auto* const timer = static_cast<TimerData*>(_timers.Cancel(value));
+		if (!timer) {
+			Py_RETURN_FALSE;
+		}
+		Py_DECREF(timer->callback);
+		delete timer;
+		Py_RETURN_TRUE;
+	}
+
+	PyObject* Python3LanguageModule::EnableCollector(double budget, double fullInterval) {
+		if (!_collector.collect) {
+			PyObject* const gcModule = PyImport_ImportModule("gc");
+			if (!gcModule) {
+				return nullptr;
+			}
+			PyObject* const collect = PyObject_GetAttrString(gcModule, "collect");
+			PyObject* const getCount = PyObject_GetAttrString(gcModule, "get_count");
+			PyObject* const freeze = PyObject_GetAttrString(gcModule, "freeze");
+			PyObject* const thresholds = PyObject_CallMethod(gcModule, "get_threshold", nullptr);
+			Py_DECREF(gcModule);
+			if (!collect || !getCount || !freeze || !thresholds || !PyTuple_Check(thresholds) || PyTuple_Size(thresholds) < 2) {
+				Py_XDECREF(collect);
+				Py_XDECREF(getCount);
+				Py_XDECREF(freeze);
+				Py_XDECREF(thresholds);
+				if (!PyErr_Occurred()) {
+					PyErr_SetString(PyExc_RuntimeError, "Unexpected gc.get_threshold result");
+				}
+				return nullptr;
+			}
+			_collector.thresholds = { PyLong_AsLongLong(PyTuple_GET_ITEM(thresholds, 0)), PyLong_AsLongLong(PyTuple_GET_ITEM(thresholds, 1)) };
+			Py_DECREF(thresholds);
+			_collector.collect = collect;
+			_collector.getCount = getCount;
+			_collector.freeze = freeze;
+		}
+
+		PyGC_Disable();
+
+		MarkUpdateBusy();
+		_collector.enabled = true;
+		_collector.freezePending = true;
+		_collector.budget = budget;
+		_collector.fullInterval = fullInterval;
+		_collector.sinceFull = 0.0;
+
+		Py_RETURN_NONE;
+	}
+
+	PyObject* Python3LanguageModule::DisableCollector() {
+		if (_collector.enabled) {
+			PyGC_Enable();
+			_collector.enabled = false;
+			_collector.freezePending = false;
+			_collector.fullRequested = false;
+		}
+		Py_RETURN_NONE;
+	}
+
+	PyObject* Python3LanguageModule::RequestFullCollection() {
+		_collector.fullRequested = true;
+		Py_RETURN_NONE;
+	}
+
+	PyObject* Python3LanguageModule::GetCollectorStats() const {
+		return Py_BuildValue("{s:O,s:d,s:d,s:d,s:(KKK)}",
+							 "enabled", _collector.enabled ? Py_True : Py_False,
+							 "frame_pause", _collector.framePause,
+							 "max_pause", _collector.maxPause,
+							 "total_pause", _collector.totalPause,
+							 "collections",
+							 static_cast<unsigned long long>(_collector.collections[0]),
+							 static_cast<unsigned long long>(_collector.collections[1]),
+							 static_cast<unsigned long long>(_collector.collections[2]));
+	}
+
+	PyObject* Python3LanguageModule::EnableStringCache(Py_ssize_t capacity, Py_ssize_t maxLength) {
+		_stringCache.Configure(static_cast<size_t>(capacity), static_cast<size_t>(maxLength));
+		Py_RETURN_NONE;
+	}
+
+	PyObject* Python3LanguageModule::DisableStringCache() {
+		_stringCache.Configure(0, 0);
+		Py_RETURN_NONE;
+	}
+
+	CallbackOptions* Python3LanguageModule::AddCallbackOptions(PyObject* function, const CallOptions& options, PyObject* plugin) {
+		return _callbackOptions.emplace_back(std::make_unique<CallbackOptions>(function, options, plugin)).get();
+	}
+
+	bool Python3LanguageModule::IsExternalFunction(PyObject* object) const {
+		if (!PyCFunction_Check(object)) {
+			return false;
+		}
+		const PyMethodDef* const def = reinterpret_cast<PyCFunctionObject*>(object)->m_ml;
+		for (const auto& methods : _moduleMethods) {
+			if (std::any_of(methods.begin(), methods.end(), [def](const PyMethodDef& method) { return &method == def; })) {
+				return true;
+			}
+		}
+		return std::any_of(_externalFunctions.begin(), _externalFunctions.end(), [def](const ExternalHolder& holder) { return holder.def.get() == def; });
+	}
+
+	PyObject* Python3LanguageModule::RefObjectHandle(PyObject* object) {
+		void* const handle = _handles.Ref(object);
+		if (!handle) {
+			PyErr_SetString(PyExc_OverflowError, "Too many live handles");
+			return nullptr;
+		}
+		return PyLong_FromVoidPtr(handle);
+	}
+
+	PyObject* Python3LanguageModule::ResolveObjectHandle(PyObject* handle) const {
+		void* const value = PyLong_AsVoidPtr(handle);
+		if (!value && PyErr_Occurred()) {
+			return nullptr;
+		}
+		PyObject* const object = ObjectFromHandle(value);
+		if (!object) {
+			PyErr_SetString(PyExc_KeyError, "Handle is not live");
+			return nullptr;
+		}
+		return Py_NewRef(object);
+	}
+
+	PyObject* Python3LanguageModule::ReleaseObjectHandle(PyObject* handle) {
+		void* const value = PyLong_AsVoidPtr(handle);
+		if (!value && PyErr_Occurred()) {
+			return nullptr;
+		}
+		if (!_handles.Release(value)) {
+			PyErr_SetString(PyExc_KeyError, "Handle is not live");
+			return nullptr;
+		}
+		Py_RETURN_NONE;
+	}
+
+	PyObject* Python3LanguageModule::GetObjectHandleCount() const {
+		return PyLong_FromSize_t(_handles.Size());
+	}
+
+	PyObject* Python3LanguageModule::GetStringCacheStats() const {
+		return Py_BuildValue("{s:n,s:n,s:K,s:K}",
+							 "capacity", static_cast<Py_ssize_t>(_stringCache.Capacity()),
+							 "max_length", static_cast<Py_ssize_t>(_stringCache.MaxLength()),
+							 "hits", static_cast<unsigned long long>(_stringCache.Hits()),
+							 "misses", static_cast<unsigned long long>(_stringCache.Misses()));
+	}
+
+	double Python3LanguageModule::CollectGeneration(int generation) {
+		const auto start = std::chrono::steady_clock::now();
+		PyObject* const returnObject = PyObject_CallFunction(_collector.collect, "i", generation);
+		const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		if (!returnObject) {
+			LogError();
+		} else {
+			Py_DECREF(returnObject);
+		}
+		++_collector.collections[static_cast<size_t>(generation)];
+		return duration.count();
+	}
+
+	void Python3LanguageModule::UpdateCollector(DateTime dt) {
+		if (!_collector.enabled) {
+			return;
+		}
+
+		double pause = 0.0;
+
+		if (_collector.freezePending) {
+			// Move everything which survived plugin loading out of future collections
+			_collector.freezePending = false;
+			pause += CollectGeneration(2);
+			if (PyObject* const returnObject = PyObject_CallNoArgs(_collector.freeze)) {
+				Py_DECREF(returnObject);
+			} else {
+				LogError();
+			}
+			_collector.sinceFull = 0.0;
+		} else {
+			_collector.sinceFull += static_cast<double>(dt.AsSeconds());
+
+			if (_collector.fullRequested || (_collector.fullInterval > 0.0 && _collector.sinceFull >= _collector.fullInterval)) {
+				_collector.fullRequested = false;
+				_collector.sinceFull = 0.0;
+				pause += CollectGeneration(2);
+			} else {
+				PyObject* const count = PyObject_CallNoArgs(_collector.getCount);
+				if (!count) {
+					LogError();
+					return;
+				}
+				const int64_t count0 = PyLong_AsLongLong(PyTuple_GET_ITEM(count, 0));
+				const int64_t count1 = PyLong_AsLongLong(PyTuple_GET_ITEM(count, 1));
+				Py_DECREF(count);
+
+				if (count0 >= _collector.thresholds[0]) {
+					pause += CollectGeneration(0);
+				}
+				// Generation 1 waits for a frame with spare budget, unless it grew far beyond threshold
+				if (count1 >= _collector.thresholds[1] && (pause < _collector.budget || count1 >= _collector.thresholds[1] * 4)) {
+					pause += CollectGeneration(1);
+				}
+			}
+		}
+
+		_collector.framePause = pause;
+		if (pause > 0.0) {
+			_collector.maxPause = std::max(_collector.maxPause, pause);
+			_collector.totalPause += pause;
 		}
+	}
 
-		PyObject* startPlugin = PyObject_GetAttrString(pluginInstance, "plugin_start");
-		if (!startPlugin) {
-			PyErr_Clear();
-		} else if (!PyFunction_Check(startPlugin) && !PyCallable_Check(startPlugin)) {
-			exportErrors.emplace_back("plugin_start");
+	bool Python3LanguageModule::InitEventLoop(PyObject* aioModule) {
+		_aioStep = PyObject_GetAttrString(aioModule, "step");
+		_aioCreateTask = PyObject_GetAttrString(aioModule, "create_task");
+		_aioClose = PyObject_GetAttrString(aioModule, "close");
+		_aioCancelPlugin = PyObject_GetAttrString(aioModule, "cancel_plugin");
+		if (!_aioStep || !_aioCreateTask || !_aioClose || !_aioCancelPlugin) {
+			Py_CLEAR(_aioStep);
+			Py_CLEAR(_aioCreateTask);
+			Py_CLEAR(_aioClose);
+			Py_CLEAR(_aioCancelPlugin);
+			return false;
 		}
+		Py_INCREF(aioModule);
+		_aioModule = aioModule;
+		return true;
+	}
 
-		PyObject* endPlugin = PyObject_GetAttrString(pluginInstance, "plugin_end");
-		if (!endPlugin) {
-			PyErr_Clear();
-		} else if (!PyFunction_Check(endPlugin) && !PyCallable_Check(endPlugin)) {
-			exportErrors.emplace_back("plugin_end");
+	void Python3LanguageModule::StepEventLoop() {
+		if (_eventLoopIdle) {
+			return;
 		}
 
-		if (!exportErrors.empty()) {
-			Py_DECREF(pluginInstance);
-			Py_DECREF(pluginModule);
-			std::string errorString("Methods export error(s): " + exportErrors[0]);
-			for (auto it = std::next(exportErrors.begin()); it != exportErrors.end(); ++it) {
-				std::format_to(std::back_inserter(errorString), ", {}", *it);
+		if (!_aioModule) {
+			// Event loop is created by plugify.aio on first use, plugins may import it directly
+			PyObject* const aioModule = PyDict_GetItemString(PyImport_GetModuleDict(), "plugify.aio");
+			if (!aioModule) {
+				_eventLoopIdle = true;
+				return;
+			}
+			if (!InitEventLoop(aioModule)) {
+				LogError();
+				return;
 			}
-			return ErrorData{ std::move(errorString) };
 		}
 
-		const auto [it, result] = _pluginsMap.try_emplace(plugin.GetId(), pluginModule, pluginInstance, updatePlugin, startPlugin, endPlugin);
-		if (!result) {
-			Py_DECREF(pluginInstance);
-			Py_DECREF(pluginModule);
-			return ErrorData{ std::format("Save plugin data to map unsuccessful") };
+		// Returns whether the loop still has work, a failed step is retried on the next update
+		PyObject* const returnObject = PyObject_CallNoArgs(_aioStep);
+		if (!returnObject) {
+			LogError();
+			_provider->Log(LOG_PREFIX "Event loop step failed", Severity::Error);
+			return;
 		}
+		_eventLoopIdle = returnObject == Py_False;
+		Py_DECREF(returnObject);
+	}
 
-		std::vector<MethodData> methods;
-		methods.reserve(methodsHolders.size());
-		_pythonMethods.reserve(methodsHolders.size());
+	void Python3LanguageModule::WakeEventLoop() {
+		_eventLoopIdle = false;
+		MarkUpdateBusy();
+	}
 
-		for (auto& [method, methodData] : methodsHolders) {
-			const MemAddr methodAddr = methodData.jitCallback.GetFunction();
-			methods.emplace_back(method, methodAddr);
-			AddToFunctionsMap(methodAddr, methodData.pythonFunction);
-			_pythonMethods.emplace_back(std::move(methodData));
+	PyObject* Python3LanguageModule::GetPluginIdObject(UniqueId id) {
+		const auto it = _pluginIds.find(id);
+		if (it != _pluginIds.end()) {
+			return it->second;
 		}
-
-		return LoadResultData{ std::move(methods), &it->second, { updatePlugin != nullptr, startPlugin != nullptr, endPlugin != nullptr, !exportedMethods.empty() } };
+		PyObject* const object = PyLong_FromLongLong(static_cast<long long>(id));
+		if (object) {
+			_pluginIds.emplace(id, object);
+		}
+		return object;
 	}
 
-	void Python3LanguageModule::OnPluginStart(PluginHandle plugin) {
-		GILLock lock{};
-		PyObject* const returnObject = PyObject_CallNoArgs(plugin.GetData().RCast<PluginData*>()->start);
-		if (!returnObject) {
-			LogError();
-			_provider->Log(std::format(LOG_PREFIX "{}: call of 'plugin_start' failed", plugin.GetName()), Severity::Error);
+	PyObject* Python3LanguageModule::CurrentPlugin() const {
+		if (!_pluginContextVar) {
+			return nullptr;
+		}
+		PyObject* plugin = nullptr;
+		if (PyContextVar_Get(_pluginContextVar, nullptr, &plugin) != 0) {
+			PyErr_Clear();
+			return nullptr;
 		}
+		// Context only holds id objects from _pluginIds, which outlive it
+		Py_XDECREF(plugin);
+		return plugin;
 	}
 
-	void Python3LanguageModule::OnPluginUpdate(PluginHandle plugin, DateTime dt) {
-		GILLock lock{};
-		PyObject* const deltaTime = CreatePyObject(dt.AsSeconds());
-		PyObject* const returnObject = PyObject_CallOneArg(plugin.GetData().RCast<PluginData*>()->update, deltaTime);
-		if (!returnObject) {
-			LogError();
-			_provider->Log(std::format(LOG_PREFIX "{}: call of 'plugin_update' failed", plugin.GetName()), Severity::Error);
+	PyObject* Python3LanguageModule::CreateTask(PyObject* coroutine) {
+		if (!_aioModule) {
+			PyObject* const aioModule = PyImport_ImportModule("plugify.aio");
+			if (!aioModule) {
+				return nullptr;
+			}
+			const bool result = InitEventLoop(aioModule);
+			Py_DECREF(aioModule);
+			if (!result) {
+				return nullptr;
+			}
 		}
+		return PyObject_CallOneArg(_aioCreateTask, coroutine);
+	}
+
+	void Python3LanguageModule::OnPluginUpdate(PluginHandle, DateTime) {
+		// plugin_update is dispatched in OnUpdate
 	}
 
 	void Python3LanguageModule::OnPluginEnd(PluginHandle plugin) {
+		auto* const pluginData = plugin.GetData().RCast<PluginData*>();
 		GILLock lock{};
-		PyObject* const returnObject = PyObject_CallNoArgs(plugin.GetData().RCast<PluginData*>()->end);
-		if (!returnObject) {
-			LogError();
-			_provider->Log(std::format(LOG_PREFIX "{}: call of 'plugin_end' failed", plugin.GetName()), Severity::Error);
+		PluginContextScope pluginContext(pluginData->id);
+		const auto ended = [id = plugin.GetId()](UpdateData& data) {
+			if (data.plugin.GetId() != id) {
+				return false;
+			}
+			if (data.task) {
+				CancelTask(data.task);
+				Py_CLEAR(data.task);
+			}
+			return true;
+		};
+		if (_dispatchingUpdates) {
+			// Entries are erased after the dispatch loop, plugin_update of this plugin may still be running
+			for (auto& data : _updatePlugins) {
+				if (ended(data)) {
+					data.ended = true;
+				}
+			}
+		} else {
+			std::erase_if(_updatePlugins, ended);
+		}
+		std::erase_if(_startedUpdatePlugins, ended);
+		if (pluginData->end) {
+			PyObject* const returnObject = PyObject_CallNoArgs(pluginData->end);
+			if (!returnObject) {
+				LogError();
+				_provider->Log(std::format(LOG_PREFIX "{}: call of 'plugin_end' failed", plugin.GetName()), Severity::Error);
+			} else {
+				Py_DECREF(returnObject);
+			}
 		}
+		// Tasks and loop callbacks started by the plugin would call into it after it is unloaded
+		if (_aioModule) {
+			if (PyObject* const returnObject = PyObject_CallOneArg(_aioCancelPlugin, pluginData->id)) {
+				Py_DECREF(returnObject);
+			} else {
+				LogError();
+			}
+		}
+		// Timers of the plugin would call into it after it is unloaded
+		_timers.CancelIf([plugin = pluginData->id](void* data) {
+			return static_cast<TimerData*>(data)->plugin == plugin;
+		}, [](void* data) {
+			auto* const timer = static_cast<TimerData*>(data);
+			Py_DECREF(timer->callback);
+			delete timer;
+		});
 	}
 
 	bool Python3LanguageModule::IsDebugBuild() {
@@ -3829,7 +6481,8 @@ namespace py3lm {
 			return funcAddr;
 		}
 
-		auto [result, callback] = CreateInternalCall(_jitRuntime, method, object);
+		// Callback runs as code of the plugin which passed it to native code
+		auto [result, callback] = CreateInternalCall(_jitRuntime, method, object, CurrentPlugin());
 
 		if (!result) {
 			const std::string error(std::format("Lang module JIT failed to generate C++ wrapper from callback object '{}'", callback.GetError()));
@@ -3847,347 +6500,120 @@ namespace py3lm {
 	}
 
 	PyObject* Python3LanguageModule::CreateVector2Object(const plg::vec2& vector) {
-		PyObject* const args = PyTuple_New(Py_ssize_t{ 2 });
-		if (!args) {
-			PyErr_SetString(PyExc_RuntimeError, "Fail to create arguments tuple");
-			return nullptr;
-		}
-		// CreatePyObject set error
-		PyObject* const xObject = CreatePyObject(vector.x);
-		if (!xObject) {
-			Py_DECREF(args);
+		auto* const type = reinterpret_cast<PyTypeObject*>(_Vector2TypeObject);
+		auto* const vectorObject = reinterpret_cast<Vector2Object*>(type->tp_alloc(type, 0));
+		if (!vectorObject) {
 			return nullptr;
 		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 0 }, xObject); // xObject ref taken by tuple
-		PyObject* const yObject = CreatePyObject(vector.y);
-		if (!yObject) {
-			Py_DECREF(args);
-			return nullptr;
-		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 1 }, yObject); // yObject ref taken by tuple
-		PyObject* const vectorObject = PyObject_CallObject(_Vector2TypeObject, args);
-		Py_DECREF(args);
-		return vectorObject;
+		vectorObject->data[0] = static_cast<double>(vector.x);
+		vectorObject->data[1] = static_cast<double>(vector.y);
+		return reinterpret_cast<PyObject*>(vectorObject);
 	}
 
 	std::optional<plg::vec2> Python3LanguageModule::Vector2ValueFromObject(PyObject* object) {
-		const int typeResult = PyObject_IsInstance(object, _Vector2TypeObject);
-		if (typeResult == -1) {
-			// Python exception was set by PyObject_IsInstance
-			return std::nullopt;
-		}
-		if (typeResult == 0) {
+		if (!PyObject_TypeCheck(object, reinterpret_cast<PyTypeObject*>(_Vector2TypeObject))) {
 			SetTypeError("Expected Vector2", object);
 			return std::nullopt;
 		}
-		auto xValue = GetObjectAttrAsValue<float>(object, "x");
-		if (!xValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		auto yValue = GetObjectAttrAsValue<float>(object, "y");
-		if (!yValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		return plg::vec2{ *xValue, *yValue };
+		const double* const data = reinterpret_cast<Vector2Object*>(object)->data;
+		return plg::vec2{ static_cast<float>(data[0]), static_cast<float>(data[1]) };
 	}
 
 	PyObject* Python3LanguageModule::CreateVector3Object(const plg::vec3& vector) {
-		PyObject* const args = PyTuple_New(Py_ssize_t{ 3 });
-		if (!args) {
-			PyErr_SetString(PyExc_RuntimeError, "Fail to create arguments tuple");
-			return nullptr;
-		}
-		// CreatePyObject set error
-		PyObject* const xObject = CreatePyObject(vector.x);
-		if (!xObject) {
-			Py_DECREF(args);
-			return nullptr;
-		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 0 }, xObject); // xObject ref taken by tuple
-		PyObject* const yObject = CreatePyObject(vector.y);
-		if (!yObject) {
-			Py_DECREF(args);
-			return nullptr;
-		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 1 }, yObject); // yObject ref taken by tuple
-		PyObject* const zObject = CreatePyObject(vector.z);
-		if (!zObject) {
-			Py_DECREF(args);
+		auto* const type = reinterpret_cast<PyTypeObject*>(_Vector3TypeObject);
+		auto* const vectorObject = reinterpret_cast<Vector3Object*>(type->tp_alloc(type, 0));
+		if (!vectorObject) {
 			return nullptr;
 		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 2 }, zObject); // zObject ref taken by tuple
-		PyObject* const vectorObject = PyObject_CallObject(_Vector3TypeObject, args);
-		Py_DECREF(args);
-		return vectorObject;
+		vectorObject->data[0] = static_cast<double>(vector.x);
+		vectorObject->data[1] = static_cast<double>(vector.y);
+		vectorObject->data[2] = static_cast<double>(vector.z);
+		return reinterpret_cast<PyObject*>(vectorObject);
 	}
 
 	std::optional<plg::vec3> Python3LanguageModule::Vector3ValueFromObject(PyObject* object) {
-		const int typeResult = PyObject_IsInstance(object, _Vector3TypeObject);
-		if (typeResult == -1) {
-			// Python exception was set by PyObject_IsInstance
-			return std::nullopt;
-		}
-		if (typeResult == 0) {
+		if (!PyObject_TypeCheck(object, reinterpret_cast<PyTypeObject*>(_Vector3TypeObject))) {
 			SetTypeError("Expected Vector3", object);
 			return std::nullopt;
 		}
-		auto xValue = GetObjectAttrAsValue<float>(object, "x");
-		if (!xValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		auto yValue = GetObjectAttrAsValue<float>(object, "y");
-		if (!yValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		auto zValue = GetObjectAttrAsValue<float>(object, "z");
-		if (!zValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		return plg::vec3{ *xValue, *yValue, *zValue };
+		const double* const data = reinterpret_cast<Vector3Object*>(object)->data;
+		return plg::vec3{ static_cast<float>(data[0]), static_cast<float>(data[1]), static_cast<float>(data[2]) };
 	}
 
 	PyObject* Python3LanguageModule::CreateVector4Object(const plg::vec4& vector) {
-		PyObject* const args = PyTuple_New(Py_ssize_t{ 4 });
-		if (!args) {
-			PyErr_SetString(PyExc_RuntimeError, "Fail to create arguments tuple");
-			return nullptr;
-		}
-		// CreatePyObject set error
-		PyObject* const xObject = CreatePyObject(vector.x);
-		if (!xObject) {
-			Py_DECREF(args);
-			return nullptr;
-		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 0 }, xObject); // xObject ref taken by tuple
-		PyObject* const yObject = CreatePyObject(vector.y);
-		if (!yObject) {
-			Py_DECREF(args);
-			return nullptr;
-		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 1 }, yObject); // yObject ref taken by tuple
-		PyObject* const zObject = CreatePyObject(vector.z);
-		if (!zObject) {
-			Py_DECREF(args);
-			return nullptr;
-		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 2 }, zObject); // zObject ref taken by tuple
-		PyObject* const wObject = CreatePyObject(vector.w);
-		if (!wObject) {
-			Py_DECREF(args);
+		auto* const type = reinterpret_cast<PyTypeObject*>(_Vector4TypeObject);
+		auto* const vectorObject = reinterpret_cast<Vector4Object*>(type->tp_alloc(type, 0));
+		if (!vectorObject) {
 			return nullptr;
 		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 3 }, wObject); // wObject ref taken by tuple
-		PyObject* const vectorObject = PyObject_CallObject(_Vector4TypeObject, args);
-		Py_DECREF(args);
-		return vectorObject;
+		vectorObject->data[0] = static_cast<double>(vector.x);
+		vectorObject->data[1] = static_cast<double>(vector.y);
+		vectorObject->data[2] = static_cast<double>(vector.z);
+		vectorObject->data[3] = static_cast<double>(vector.w);
+		return reinterpret_cast<PyObject*>(vectorObject);
 	}
 
 	std::optional<plg::vec4> Python3LanguageModule::Vector4ValueFromObject(PyObject* object) {
-		const int typeResult = PyObject_IsInstance(object, _Vector4TypeObject);
-		if (typeResult == -1) {
-			// Python exception was set by PyObject_IsInstance
-			return std::nullopt;
-		}
-		if (typeResult == 0) {
+		if (!PyObject_TypeCheck(object, reinterpret_cast<PyTypeObject*>(_Vector4TypeObject))) {
 			SetTypeError("Expected Vector4", object);
 			return std::nullopt;
 		}
-		auto xValue = GetObjectAttrAsValue<float>(object, "x");
-		if (!xValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		auto yValue = GetObjectAttrAsValue<float>(object, "y");
-		if (!yValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		auto zValue = GetObjectAttrAsValue<float>(object, "z");
-		if (!zValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		auto wValue = GetObjectAttrAsValue<float>(object, "w");
-		if (!wValue) {
-			// GetObjectAttrAsValue set error. e.g. AttributeError, TypeError, ValueError
-			return std::nullopt;
-		}
-		return plg::vec4{ *xValue, *yValue, *zValue, *wValue };
+		const double* const data = reinterpret_cast<Vector4Object*>(object)->data;
+		return plg::vec4{ static_cast<float>(data[0]), static_cast<float>(data[1]), static_cast<float>(data[2]), static_cast<float>(data[3]) };
 	}
 
 	PyObject* Python3LanguageModule::CreateMatrix4x4Object(const plg::mat4x4& matrix) {
-		PyObject* const elementsObject = PyList_New(Py_ssize_t{ 16 });
-		if (!elementsObject) {
-			PyErr_SetString(PyExc_RuntimeError, "Fail to create Matrix4x4 elements list");
-			return nullptr;
-		}
-		// CreatePyObject set error
-		PyObject* const m00Object = CreatePyObject(matrix.m00);
-		if (!m00Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 0 }, m00Object); // m00Object ref taken by list
-		PyObject* const m01Object = CreatePyObject(matrix.m01);
-		if (!m01Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 1 }, m01Object); // m01Object ref taken by list
-		PyObject* const m02Object = CreatePyObject(matrix.m02);
-		if (!m02Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 2 }, m02Object); // m02Object ref taken by list
-		PyObject* const m03Object = CreatePyObject(matrix.m03);
-		if (!m03Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 3 }, m03Object); // m03Object ref taken by list
-		PyObject* const m10Object = CreatePyObject(matrix.m10);
-		if (!m10Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 4 }, m10Object); // m10Object ref taken by list
-		PyObject* const m11Object = CreatePyObject(matrix.m11);
-		if (!m11Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 5 }, m11Object); // m11Object ref taken by list
-		PyObject* const m12Object = CreatePyObject(matrix.m12);
-		if (!m12Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 6 }, m12Object); // m12Object ref taken by list
-		PyObject* const m13Object = CreatePyObject(matrix.m13);
-		if (!m13Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 7 }, m13Object); // m13Object ref taken by list
-		PyObject* const m20Object = CreatePyObject(matrix.m20);
-		if (!m20Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 8 }, m20Object); // m20Object ref taken by list
-		PyObject* const m21Object = CreatePyObject(matrix.m21);
-		if (!m21Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 9 }, m21Object); // m21Object ref taken by list
-		PyObject* const m22Object = CreatePyObject(matrix.m22);
-		if (!m22Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 10 }, m22Object); // m22Object ref taken by list
-		PyObject* const m23Object = CreatePyObject(matrix.m23);
-		if (!m23Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 11 }, m23Object); // m23Object ref taken by list
-		PyObject* const m30Object = CreatePyObject(matrix.m30);
-		if (!m30Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 12 }, m30Object); // m30Object ref taken by list
-		PyObject* const m31Object = CreatePyObject(matrix.m31);
-		if (!m31Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
-		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 13 }, m31Object); // m31Object ref taken by list
-		PyObject* const m32Object = CreatePyObject(matrix.m32);
-		if (!m32Object) {
-			Py_DECREF(elementsObject);
+		PyObject* const rowsObject = PyList_New(Py_ssize_t{ 4 });
+		if (!rowsObject) {
 			return nullptr;
 		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 14 }, m32Object); // m32Object ref taken by list
-		PyObject* const m33Object = CreatePyObject(matrix.m33);
-		if (!m33Object) {
-			Py_DECREF(elementsObject);
-			return nullptr;
+		for (Py_ssize_t i = 0; i < Py_ssize_t{ 4 }; ++i) {
+			PyObject* const rowObject = PyList_New(Py_ssize_t{ 4 });
+			if (!rowObject) {
+				Py_DECREF(rowsObject);
+				return nullptr;
+			}
+			PyList_SET_ITEM(rowsObject, i, rowObject); // rowObject ref taken by list
+			for (Py_ssize_t j = 0; j < Py_ssize_t{ 4 }; ++j) {
+				// CreatePyObject set error
+				PyObject* const mObject = CreatePyObject(matrix.data[static_cast<size_t>(i * Py_ssize_t{ 4 } + j)]);
+				if (!mObject) {
+					Py_DECREF(rowsObject);
+					return nullptr;
+				}
+				PyList_SET_ITEM(rowObject, j, mObject); // mObject ref taken by list
+			}
 		}
-		PyList_SET_ITEM(elementsObject, Py_ssize_t{ 15 }, m33Object); // m33Object ref taken by list
-		PyObject* const args = PyTuple_New(Py_ssize_t{ 1 });
-		if (!args) {
-			Py_DECREF(elementsObject);
-			PyErr_SetString(PyExc_RuntimeError, "Fail to create arguments tuple");
+		auto* const type = reinterpret_cast<PyTypeObject*>(_Matrix4x4TypeObject);
+		auto* const matrixObject = reinterpret_cast<Matrix4x4Object*>(type->tp_alloc(type, 0));
+		if (!matrixObject) {
+			Py_DECREF(rowsObject);
 			return nullptr;
 		}
-		PyTuple_SET_ITEM(args, Py_ssize_t{ 0 }, elementsObject); // elementsObject ref taken by tuple
-		PyObject* const vectorObject = PyObject_CallObject(_Matrix4x4TypeObject, args);
-		Py_DECREF(args);
-		return vectorObject;
+		matrixObject->m = rowsObject; // rowsObject ref taken by matrix
+		return reinterpret_cast<PyObject*>(matrixObject);
 	}
 
 	std::optional<plg::mat4x4> Python3LanguageModule::Matrix4x4ValueFromObject(PyObject* object) {
-		const int typeResult = PyObject_IsInstance(object, _Matrix4x4TypeObject);
-		if (typeResult == -1) {
-			// Python exception was set by PyObject_IsInstance
-			return std::nullopt;
-		}
-		if (typeResult == 0) {
+		if (!PyObject_TypeCheck(object, reinterpret_cast<PyTypeObject*>(_Matrix4x4TypeObject))) {
 			SetTypeError("Expected Matrix4x4", object);
 			return std::nullopt;
 		}
-		PyObject* const elementsListObject = PyObject_GetAttrString(object, "m");
-		if (!elementsListObject) {
-			// PyObject_GetAttrString set error. e.g. AttributeError
-			return std::nullopt;
-		}
-		if (!PyList_CheckExact(elementsListObject)) {
-			Py_DECREF(elementsListObject);
-			PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 list");
-			return std::nullopt;
-		}
-		if (PyList_Size(elementsListObject) != Py_ssize_t{ 4 }) {
-			Py_DECREF(elementsListObject);
+		PyObject* const elementsListObject = reinterpret_cast<Matrix4x4Object*>(object)->m;
+		if (!elementsListObject || !PyList_CheckExact(elementsListObject) || PyList_GET_SIZE(elementsListObject) != Py_ssize_t{ 4 }) {
 			PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 list");
 			return std::nullopt;
 		}
 		plg::mat4x4 matrix{};
 		for (Py_ssize_t i = 0; i < Py_ssize_t{ 4 }; ++i) {
-			PyObject* const elementsRowListObject = PyList_GetItem(elementsListObject, i);
-			if (!elementsRowListObject) [[unlikely]] {
-				Py_DECREF(elementsListObject);
-				// PyList_GetItem set error. e.g. IndexError
-				return std::nullopt;
-			}
-			if (!PyList_CheckExact(elementsRowListObject)) {
-				Py_DECREF(elementsListObject);
-				PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 list");
-				return std::nullopt;
-			}
-			if (PyList_Size(elementsRowListObject) != Py_ssize_t{ 4 }) {
-				Py_DECREF(elementsListObject);
+			PyObject* const elementsRowListObject = PyList_GET_ITEM(elementsListObject, i);
+			if (!PyList_CheckExact(elementsRowListObject) || PyList_GET_SIZE(elementsRowListObject) != Py_ssize_t{ 4 }) {
 				PyErr_SetString(PyExc_ValueError, "Elements must be a 4x4 list");
 				return std::nullopt;
 			}
 			for (Py_ssize_t j = 0; j < Py_ssize_t{ 4 }; ++j) {
-				PyObject* const mObject = PyList_GetItem(elementsRowListObject, j);
-				if (!mObject) [[unlikely]] {
-					Py_DECREF(elementsListObject);
-					/// PyList_GetItem set error. e.g. IndexError
-					return std::nullopt;
-				}
-				const auto mValue = ValueFromObject<float>(mObject);
+				const auto mValue = ValueFromObject<float>(PyList_GET_ITEM(elementsRowListObject, j));
 				if (!mValue) {
-					Py_DECREF(elementsListObject);
 					// ValueFromObject set error. e.g. TypeError
 					return std::nullopt;
 				}
@@ -4284,80 +6710,177 @@ namespace py3lm {
 	}
 
 	void Python3LanguageModule::CreateEnumObject(plugify::EnumHandle enumerator, PyObject* moduleDict) {
-		PyObject* enumClass = PyDict_GetItemString(moduleDict, enumerator.GetName().data());
-		if (enumClass) {
-			const auto it = _internalEnumMap.find(enumClass);
-			if (it != _internalEnumMap.end()) {
-				_externalEnumMap.try_emplace(enumerator, it->second);
-			}
+		std::string name(enumerator.GetName());
+		// Dict is kept alive while it is a key, so its address can't be reused by another module
+		const auto [moduleIt, moduleInserted] = _moduleEnumMap.try_emplace(moduleDict);
+		if (moduleInserted) {
+			Py_INCREF(moduleDict);
+		}
+		PythonModuleEnums& moduleEnums = moduleIt->second;
+		const auto it = moduleEnums.enums.find(name);
+		if (it != moduleEnums.enums.end()) {
+			_externalEnumMap.try_emplace(enumerator, it->second);
 			return;
 		}
 
-		const auto values = enumerator.GetValues();
-		if (values.empty()) {
+		if (PyDict_GetItemString(moduleDict, name.c_str()) || enumerator.GetValues().empty()) {
 			return;
 		}
 
-		PyObject* constantsDict = PyDict_New();
-		for (const auto& value : values) {
-			assert(PyDict_SetItemString(constantsDict, value.GetName().data(), PyLong_FromLongLong(value.GetValue())) == 0);
+		auto [it2, inserted] = _externalEnumMap.try_emplace(enumerator, nullptr);
+		if (inserted) {
+			it2->second = _enums.emplace_back(std::make_unique<PythonEnumData>(PythonEnumData{ enumerator })).get();
 		}
+		PythonEnumData& data = *it2->second;
+		moduleEnums.enums.emplace(name, &data);
 
-		enumClass = PyObject_CallMethod(_enumModule, "IntEnum", "sO", enumerator.GetName().data(), constantsDict);
+		if (data.type) {
+			if (PyDict_SetItemString(moduleDict, name.c_str(), data.type) < 0) {
+				LogError();
+			}
+			return;
+		}
 
-		Py_DECREF(constantsDict);
+		data.moduleDicts.push_back(moduleDict);
 
-		if (enumClass && PyDict_SetItemString(moduleDict, enumerator.GetName().data(), enumClass) < 0) {
+		// Class is created by module __getattr__ on first access, which falls back to __getattr__ module defined before
+		if (!moduleEnums.lazy) {
+			static PyMethodDef method = { "__getattr__", &LazyEnumGetAttr, METH_O, nullptr };
+			PyObject* const moduleKey = PyLong_FromVoidPtr(moduleDict);
+			PyObject* const getattrFunc = moduleKey ? PyCFunction_NewEx(&method, moduleKey, nullptr) : nullptr;
+			Py_XDECREF(moduleKey);
+			PyObject* const previous = Py_XNewRef(PyDict_GetItemString(moduleDict, "__getattr__"));
+			if (getattrFunc && PyDict_SetItemString(moduleDict, "__getattr__", getattrFunc) == 0) {
+				moduleEnums.getattr = previous;
+				moduleEnums.lazy = true;
+			} else {
+				Py_XDECREF(previous);
+				LogError();
+			}
+			Py_XDECREF(getattrFunc);
+		}
+
+		if (!moduleEnums.lazy && !MaterializeEnum(data)) {
 			LogError();
-			Py_DECREF(enumClass);
-			return;
 		}
+	}
 
-		auto it = _externalEnumMap.find(enumerator);
-		if (it == _externalEnumMap.end()) {
-			it = _externalEnumMap.emplace(enumerator, std::make_shared<PythonEnumMap>()).first;
+	PyObject* Python3LanguageModule::MaterializeEnum(PythonEnumData& data) {
+		if (data.type) {
+			return data.type;
 		}
 
-		auto& enumMap = it->second;
+		const auto values = data.enumerator.GetValues();
+		std::vector<int64_t> numbers;
+		numbers.reserve(values.size());
+
+		PyObject* const constantsDict = PyDict_New();
+		if (!constantsDict) {
+			return nullptr;
+		}
 		for (const auto& value : values) {
-			const int64_t i = value.GetValue();
-			(*enumMap)[i] = PyObject_CallOneArg(enumClass, CreatePyObject(i));
+			PyObject* const number = PyLong_FromLongLong(value.GetValue());
+			if (!number || PyDict_SetItemString(constantsDict, value.GetName().data(), number) < 0) {
+				Py_XDECREF(number);
+				Py_DECREF(constantsDict);
+				return nullptr;
+			}
+			Py_DECREF(number);
+			numbers.push_back(value.GetValue());
+		}
+
+		if (!_enumModule) {
+			_enumModule = PyImport_ImportModule("enum");
+			if (!_enumModule) {
+				Py_DECREF(constantsDict);
+				return nullptr;
+			}
+		}
+
+		const std::string_view name = data.enumerator.GetName();
+		PyObject* const enumClass = PyObject_CallMethod(_enumModule, "IntEnum", "s#O", name.data(), static_cast<Py_ssize_t>(name.size()), constantsDict);
+
+		Py_DECREF(constantsDict);
+
+		if (!enumClass) {
+			return nullptr;
+		}
+
+		// Aliases resolve to the same member, so look each value up only once
+		std::sort(numbers.begin(), numbers.end());
+		numbers.erase(std::unique(numbers.begin(), numbers.end()), numbers.end());
+
+		std::vector<std::pair<int64_t, PyObject*>> members;
+		members.reserve(numbers.size());
+		for (const int64_t i : numbers) {
+			PyObject* const number = PyLong_FromLongLong(i);
+			PyObject* const member = number ? PyObject_CallOneArg(enumClass, number) : nullptr;
+			Py_XDECREF(number);
+			if (!member) {
+				for (const auto& [_, object] : members) {
+					Py_DECREF(object);
+				}
+				Py_DECREF(enumClass);
+				return nullptr;
+			}
+			members.emplace_back(i, member);
+		}
+
+		data.members.Build(std::move(members));
+		data.type = enumClass;
+
+		for (PyObject* const moduleDict : data.moduleDicts) {
+			if (!PyDict_GetItemString(moduleDict, name.data()) && PyDict_SetItemString(moduleDict, name.data(), enumClass) < 0) {
+				LogError();
+			}
 		}
+		data.moduleDicts = {};
 
-		_internalEnumMap.try_emplace(enumClass, enumMap);
+		return enumClass;
 	}
 
-	PyObject* Python3LanguageModule::GetEnumObject(EnumHandle enumerator, int64_t value) const {
-		const auto it1 = _externalEnumMap.find(enumerator);
-		if (it1 != _externalEnumMap.end()) {
-			PyObject* object;
-			const auto it2 = it1->second->find(static_cast<int64_t>(value));
-			if (it2 != it1->second->end()) {
-				object = it2->second;
-			} else {
-				object = it1->second->begin()->second;
+	PyObject* Python3LanguageModule::FindLazyEnum(PyObject* moduleDict, PyObject* name) {
+		const char* const attr = PyUnicode_AsUTF8(name);
+		if (!attr) {
+			return nullptr;
+		}
+
+		const auto it = _moduleEnumMap.find(moduleDict);
+		if (it != _moduleEnumMap.end()) {
+			const auto it2 = it->second.enums.find(attr);
+			if (it2 != it->second.enums.end()) {
+				PyObject* const enumClass = MaterializeEnum(*it2->second);
+				Py_XINCREF(enumClass);
+				return enumClass;
+			}
+			if (it->second.getattr) {
+				return PyObject_CallOneArg(it->second.getattr, name);
 			}
-			Py_INCREF(object);
-			return object;
+		}
+
+		PyErr_Format(PyExc_AttributeError, "module '%S' has no attribute '%U'", PyDict_GetItemString(moduleDict, "__name__"), name);
+		return nullptr;
+	}
+
+	const PythonEnumData* Python3LanguageModule::ResolveEnum(EnumHandle enumerator) {
+		const auto it = _externalEnumMap.find(enumerator);
+		if (it != _externalEnumMap.end()) {
+			PythonEnumData& data = *it->second;
+			if (data.type || MaterializeEnum(data)) {
+				return &data;
+			}
+			return nullptr;
 		}
 		PyErr_SetString(PyExc_ValueError, "Invalid enum");
 		return nullptr;
 	}
 
-	PythonType Python3LanguageModule::GetObjectType(PyObject* object) const {
-		PyTypeObject* const pytype = Py_TYPE(object);
-		auto it = _typeMap.find(pytype);
+	PythonType Python3LanguageModule::GetObjectTypeSlow(PyTypeObject* pytype) const {
+		const auto it = _typeMap.find(pytype);
 		if (it != _typeMap.end()) {
 			return std::get<PythonType>(*it);
 		}
-		const char* name;
-		if (pytype != nullptr) {
-			PyObject* const typeName = PyType_GetName(pytype);
-			name = PyUnicode_AsUTF8(typeName);
-		} else {
-			name = "Invalid";
-		}
-		return { PyAbstractType::Invalid, name };
+		return { PyAbstractType::Invalid, pytype->tp_name };
 	}
 
 	void Python3LanguageModule::LogError() const {
@@ -4372,6 +6895,24 @@ namespace py3lm {
 			ptraceback = Py_None;
 		}
 		PyErr_NormalizeException(&ptype, &pvalue, &ptraceback);
+		if (!_formatException) {
+			// traceback pulls a lot of modules, import it only when first error occurs
+			if (PyObject* const tracebackModule = PyImport_ImportModule("traceback")) {
+				_formatException = PyObject_GetAttrString(tracebackModule, "format_exception");
+				Py_DECREF(tracebackModule);
+			}
+			if (!_formatException) {
+				PyErr_Clear();
+				PyObject* const str = PyObject_Str(pvalue);
+				_provider->Log(std::format("Couldn't import traceback module: {}", str ? PyUnicode_AsString(str) : "unknown error"), Severity::Error);
+				Py_XDECREF(str);
+				Py_DECREF(ptype);
+				Py_DECREF(pvalue);
+				Py_DECREF(ptraceback);
+				PyErr_Clear();
+				return;
+			}
+		}
 		PyObject* strList = PyObject_CallFunctionObjArgs(_formatException, ptype, pvalue, ptraceback, nullptr);
 		Py_DECREF(ptype);
 		Py_DECREF(pvalue);
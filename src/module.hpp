@@ -5,12 +5,19 @@
 #include <plugify/language_module.hpp>
 #include <plugify/plugin.hpp>
 #include <plugify/numerics.hpp>
+#include "archive.hpp"
+#include "enum_table.hpp"
+#include "handle_table.hpp"
+#include "string_cache.hpp"
+#include "timer_wheel.hpp"
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <array>
+#include <atomic>
+#include <filesystem>
 #include <memory>
 #include <optional>
 #include <string>
-#include <map>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -27,6 +34,21 @@ namespace py3lm {
 		PyObject* pythonFunction{};
 	};
 
+	// Marshalling options of one native function or callback, chosen from python with plugify wrappers and decorators
+	struct CallOptions {
+		size_t lazyArrayMinSize = 0; // 0 means arrays are always converted to lists
+		bool nativeReturns = false; // returned vectors are moved into NativeArray
+		bool charArraysAsStr = false; // char8[] and char16[] values are passed to python as str
+		bool inPlaceRefs = false; // reference arguments are updated instead of returned in a tuple
+	};
+
+	// Passed to callbacks with options or owning plugin instead of their python function
+	struct CallbackOptions {
+		PyObject* function{};
+		CallOptions options;
+		PyObject* plugin{}; // id of plugin which created the callback, nullptr when unknown
+	};
+
 	enum class PyAbstractType : size_t {
 		Type,
 		BaseObject,
@@ -113,9 +135,22 @@ namespace py3lm {
 	using PythonInternalMap = std::unordered_map<PyObject*, void*>;
 	using PythonExternalMap = std::unordered_map<void*, PyObject*>;
 	using PythonTypeMap = std::unordered_map<PyTypeObject*, PythonType>;
-	using PythonEnumMap = std::map<int64_t, PyObject*>;
-	using PythonExternalEnumMap = std::unordered_map<plugify::EnumHandle, std::shared_ptr<PythonEnumMap>>;
-	using PythonInternalEnumMap = std::unordered_map<PyObject*, std::shared_ptr<PythonEnumMap>>;
+
+	struct PythonEnumData {
+		plugify::EnumHandle enumerator;
+		PyObject* type{}; // IntEnum class, created on first attribute access or conversion
+		EnumTable<PyObject*> members;
+		std::vector<PyObject*> moduleDicts; // where to publish the class once created
+	};
+
+	struct PythonModuleEnums {
+		std::unordered_map<std::string, PythonEnumData*> enums;
+		bool lazy{}; // module __getattr__ is installed
+		PyObject* getattr{}; // __getattr__ module defined before, called for other names
+	};
+
+	using PythonExternalEnumMap = std::unordered_map<plugify::EnumHandle, PythonEnumData*>;
+	using PythonModuleEnumMap = std::unordered_map<PyObject*, PythonModuleEnums>; // module dicts are strong references
 
 	class Python3LanguageModule final : public plugify::ILanguageModule {
 	public:
@@ -125,7 +160,7 @@ namespace py3lm {
 		// ILanguageModule
 		plugify::InitResult Initialize(std::weak_ptr<plugify::IPlugifyProvider> provider, plugify::ModuleHandle module) override;
 		void Shutdown() override;
-		void OnUpdate(plugify::DateTime dt) override {};
+		void OnUpdate(plugify::DateTime dt) override;
 		void OnMethodExport(plugify::PluginHandle plugin) override;
 		plugify::LoadResult OnPluginLoad(plugify::PluginHandle plugin) override;
 		void OnPluginStart(plugify::PluginHandle plugin) override;
@@ -134,6 +169,7 @@ namespace py3lm {
 		bool IsDebugBuild() override;
 
 	private:
+		PythonType GetObjectTypeSlow(PyTypeObject* pytype) const;
 		PyObject* FindExternal(void* funcAddr) const;
 		void* FindInternal(PyObject* object) const;
 		void AddToFunctionsMap(void* funcAddr, PyObject* object);
@@ -149,11 +185,95 @@ namespace py3lm {
 		std::optional<plg::vec4> Vector4ValueFromObject(PyObject* object);
 		PyObject* CreateMatrix4x4Object(const plg::mat4x4& matrix);
 		std::optional<plg::mat4x4> Matrix4x4ValueFromObject(PyObject* object);
-		PythonType GetObjectType(PyObject* type) const;
-		PyObject* GetEnumObject(plugify::EnumHandle enumerator, int64_t value) const;
+		PythonType GetObjectType(PyObject* object) const {
+			// Marshallable types and their subclasses are classified inline, the type map only names the remaining builtins
+			PyTypeObject* const pytype = Py_TYPE(object);
+			if (pytype == &PyLong_Type) {
+				return { PyAbstractType::Long, "Long" };
+			} else if (pytype == &PyFloat_Type) {
+				return { PyAbstractType::Float, "Float" };
+			} else if (pytype == &PyUnicode_Type) {
+				return { PyAbstractType::Unicode, "Unicode" };
+			} else if (pytype == &PyBool_Type) {
+				return { PyAbstractType::Bool, "Bool" };
+			} else if (pytype == &PyList_Type) {
+				return { PyAbstractType::List, "List" };
+			} else if (object == Py_None) {
+				return { PyAbstractType::None, "None" };
+			} else if (pytype == reinterpret_cast<PyTypeObject*>(_Vector3TypeObject)) {
+				return { PyAbstractType::Vector3, "Vector3" };
+			} else if (pytype == reinterpret_cast<PyTypeObject*>(_Vector2TypeObject)) {
+				return { PyAbstractType::Vector2, "Vector2" };
+			} else if (pytype == reinterpret_cast<PyTypeObject*>(_Vector4TypeObject)) {
+				return { PyAbstractType::Vector4, "Vector4" };
+			} else if (pytype == reinterpret_cast<PyTypeObject*>(_Matrix4x4TypeObject)) {
+				return { PyAbstractType::Matrix4x4, "Matrix4x4" };
+			} else if (pytype == &PyTuple_Type) {
+				return { PyAbstractType::Tuple, "Tuple" };
+			} else if (pytype == &PyDict_Type) {
+				return { PyAbstractType::Dict, "Dict" };
+			} else if (pytype == &PyBytes_Type) {
+				return { PyAbstractType::Bytes, "Bytes" };
+			}
+			// Subclasses keep their own name, e.g. IntEnum members are marshalled as Long.
+			// Float subclasses inherit nb_float, so most other types skip the MRO walk before the map lookup
+			const unsigned long flags = pytype->tp_flags;
+			if (flags & Py_TPFLAGS_LONG_SUBCLASS) {
+				return { PyAbstractType::Long, pytype->tp_name };
+			} else if (flags & Py_TPFLAGS_UNICODE_SUBCLASS) {
+				return { PyAbstractType::Unicode, pytype->tp_name };
+			} else if (flags & Py_TPFLAGS_LIST_SUBCLASS) {
+				return { PyAbstractType::List, pytype->tp_name };
+			} else if (flags & Py_TPFLAGS_TUPLE_SUBCLASS) {
+				return { PyAbstractType::Tuple, pytype->tp_name };
+			} else if (flags & Py_TPFLAGS_DICT_SUBCLASS) {
+				return { PyAbstractType::Dict, pytype->tp_name };
+			} else if (flags & Py_TPFLAGS_BYTES_SUBCLASS) {
+				return { PyAbstractType::Bytes, pytype->tp_name };
+			} else if (pytype->tp_as_number && pytype->tp_as_number->nb_float && PyType_IsSubtype(pytype, &PyFloat_Type)) {
+				return { PyAbstractType::Float, pytype->tp_name };
+			}
+			return GetObjectTypeSlow(pytype);
+		}
+		const PythonEnumData* ResolveEnum(plugify::EnumHandle enumerator);
 		void CreateEnumObject(plugify::EnumHandle enumerator, PyObject* moduleDict);
-		void ResolveRequiredModule(std::string_view moduleName);
-		std::vector<std::string> ExtractRequiredModules(const std::string& modulePath);
+		PyObject* MaterializeEnum(PythonEnumData& data);
+		PyObject* FindLazyEnum(PyObject* moduleDict, PyObject* name);
+		PyObject* CreateTask(PyObject* coroutine);
+		void WakeEventLoop();
+		PyObject* ScheduleTimer(double delay, double interval, PyObject* callback);
+		PyObject* CancelTimer(PyObject* handle);
+		PyObject* EnableCollector(double budget, double fullInterval);
+		PyObject* DisableCollector();
+		PyObject* RequestFullCollection();
+		PyObject* GetCollectorStats() const;
+		PyObject* EnableStringCache(Py_ssize_t capacity, Py_ssize_t maxLength);
+		PyObject* DisableStringCache();
+		PyObject* GetStringCacheStats() const;
+		CallbackOptions* AddCallbackOptions(PyObject* function, const CallOptions& options, PyObject* plugin);
+		PyObject* RefObjectHandle(PyObject* object);
+		PyObject* ResolveObjectHandle(PyObject* handle) const;
+		PyObject* ReleaseObjectHandle(PyObject* handle);
+		PyObject* GetObjectHandleCount() const;
+		bool IsExternalFunction(PyObject* object) const;
+
+		// Returns borrowed reference or nullptr when value is not a live handle
+		PyObject* ObjectFromHandle(void* value) const {
+			return HandleTable::IsHandle(value) ? _handles.Resolve(value) : nullptr;
+		}
+		// Id object of plugin whose code runs, borrowed reference kept until shutdown or nullptr
+		PyObject* CurrentPlugin() const;
+		PyObject* GetPluginContextVar() const { return _pluginContextVar; }
+
+		PyObject* CreateStringObject(std::string_view str) {
+			if (_stringCache.Accepts(str)) {
+				return _stringCache.Get(str);
+			}
+			return PyUnicode_FromStringAndSize(str.data(), static_cast<Py_ssize_t>(str.size()));
+		}
+		PyObject* FindModuleSpec(PyObject* fullName, std::string_view pluginName, PyObject* loader);
+		PyObject* FindArchiveSpec(PyObject* fullName, PyObject* loader);
+		PyObject* ExecArchiveModule(PyObject* module);
 
 		const std::shared_ptr<plugify::IPlugifyProvider>& GetProvider() const { return _provider; }
 		void LogFatal(std::string_view msg) const;
@@ -164,6 +284,17 @@ namespace py3lm {
 		PyObject* CreateInternalModule(plugify::PluginHandle plugin, PyObject* moduleObject = nullptr);
 		PyObject* CreateExternalModule(plugify::PluginHandle plugin, PyObject* moduleObject = nullptr);
 		void TryCreateModule(plugify::PluginHandle plugin, bool empty);
+		PyObject* ResolveRequiredModule(const std::string& pluginName);
+		void PrecompilePlugins(const std::filesystem::path& pluginsPath);
+		const Archive* MountArchive(const std::filesystem::path& archivePath); // nullptr when missing or invalid
+		void UpdatePlugins(plugify::DateTime dt);
+		void UpdateTimers(plugify::DateTime dt);
+		void UpdateCollector(plugify::DateTime dt);
+		double CollectGeneration(int generation);
+		bool InitEventLoop(PyObject* aioModule);
+		void StepEventLoop();
+		void MarkUpdateBusy() { _updateIdle.store(false, std::memory_order_release); }
+		PyObject* GetPluginIdObject(plugify::UniqueId id);
 
 	private:
 		std::shared_ptr<plugify::IPlugifyProvider> _provider;
@@ -174,8 +305,58 @@ namespace py3lm {
 			PyObject* update = nullptr;
 			PyObject* start = nullptr;
 			PyObject* end = nullptr;
+			PyObject* id = nullptr; // value of plugin context while its code runs
 		};
 		std::unordered_map<plugify::UniqueId, PluginData> _pluginsMap;
+		std::unordered_map<plugify::UniqueId, PyObject*> _pluginIds; // kept until shutdown, callbacks may outlive their plugin
+		PyObject* _pluginContextVar = nullptr;
+		struct UpdateData {
+			plugify::PluginHandle plugin;
+			PyObject* update = nullptr;
+			PyObject* id = nullptr;
+			double period = 0.0; // seconds between calls, 0 means frame based
+			uint32_t interval = 1; // frames between calls
+			uint32_t offset = 0; // frame phase, spreads plugins with the same interval
+			double budget = 0.0; // seconds, 0 means unlimited
+			double accumulator = 0.0;
+			double elapsed = 0.0; // time since last call, passed as delta time
+			bool overrun = false;
+			bool deferred = false; // due call moved to next frame, interval mode waits for it
+			bool ended = false; // plugin ended during dispatch, erased after it
+			PyObject* task = nullptr; // pending async plugin_update
+		};
+		std::vector<UpdateData> _updatePlugins;
+		std::vector<UpdateData> _startedUpdatePlugins; // started during dispatch, added after it
+		bool _dispatchingUpdates = false;
+		struct TimerData {
+			PyObject* callback = nullptr;
+			PyObject* plugin = nullptr; // id of scheduling plugin, its timers are cancelled when it ends
+		};
+		TimerWheel _timers;
+		double _timerTicks = 0.0; // fraction of tick not yet passed to timer wheel
+		struct CollectorData {
+			bool enabled = false;
+			bool freezePending = false; // freeze after plugins finished loading
+			bool fullRequested = false;
+			double budget = 0.0; // seconds per frame for generation 1 collections
+			double fullInterval = 0.0; // seconds between full collections, 0 means only on request
+			double sinceFull = 0.0;
+			std::array<int64_t, 2> thresholds{};
+			double framePause = 0.0;
+			double maxPause = 0.0;
+			double totalPause = 0.0;
+			std::array<uint64_t, 3> collections{};
+			PyObject* collect = nullptr;
+			PyObject* getCount = nullptr;
+			PyObject* freeze = nullptr;
+		};
+		CollectorData _collector;
+		StringCache _stringCache;
+		HandleTable _handles;
+		uint64_t _updateFrame = 0;
+		uint32_t _updatePhase = 0;
+		PyObject* _deltaTimeObject = nullptr;
+		double _deltaTime = 0.0;
 		std::vector<PythonMethodData> _pythonMethods;
 		PyObject* _PluginTypeObject = nullptr;
 		PyObject* _PluginInfoTypeObject = nullptr;
@@ -183,10 +364,21 @@ namespace py3lm {
 		PyObject* _Vector3TypeObject = nullptr;
 		PyObject* _Vector4TypeObject = nullptr;
 		PyObject* _Matrix4x4TypeObject = nullptr;
-		PyObject* _ExtractRequiredModulesObject = nullptr;
 		PyObject* _ppsModule = nullptr;
+		PyObject* _ppsFinder = nullptr;
+		PyObject* _archiveFinder = nullptr;
+		std::vector<std::unique_ptr<Archive>> _archives;
+		PyObject* _ModuleSpecTypeObject = nullptr;
+		PyObject* _cacheFromSourceObject = nullptr;
 		PyObject* _enumModule = nullptr;
-		PyObject* _formatException = nullptr;
+		mutable PyObject* _formatException = nullptr;
+		PyObject* _aioModule = nullptr;
+		PyObject* _aioStep = nullptr;
+		PyObject* _aioCreateTask = nullptr;
+		PyObject* _aioClose = nullptr;
+		PyObject* _aioCancelPlugin = nullptr;
+		bool _eventLoopIdle = true; // loop had no ready, timed or socket work after last step
+		std::atomic<bool> _updateIdle{ false }; // OnUpdate has nothing to do, read without GIL
 		std::vector<std::vector<PyMethodDef>> _moduleMethods;
 		struct JitHolder {
 			plugify::JitCallback jitCallback;
@@ -201,10 +393,12 @@ namespace py3lm {
 		};
 		std::vector<ExternalHolder> _externalFunctions;
 		std::vector<PythonMethodData> _internalFunctions;
+		std::vector<std::unique_ptr<CallbackOptions>> _callbackOptions;
 		PythonExternalMap _externalMap;
 		PythonInternalMap _internalMap;
 		PythonTypeMap _typeMap;
+		std::vector<std::unique_ptr<PythonEnumData>> _enums;
 		PythonExternalEnumMap _externalEnumMap;
-		PythonInternalEnumMap _internalEnumMap;
+		PythonModuleEnumMap _moduleEnumMap;
 	};
 }
@@ -0,0 +1,45 @@
+#include "process_memory.hpp"
+
+#if PY3LM_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif PY3LM_PLATFORM_APPLE
+#include <mach/mach.h>
+#else
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+namespace py3lm {
+	size_t GetResidentMemorySize() {
+#if PY3LM_PLATFORM_WINDOWS
+		PROCESS_MEMORY_COUNTERS counters{};
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+			return 0;
+		}
+		return counters.WorkingSetSize;
+#elif PY3LM_PLATFORM_APPLE
+		mach_task_basic_info info{};
+		mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+		if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+			return 0;
+		}
+		return info.resident_size;
+#else
+		FILE* const file = std::fopen("/proc/self/statm", "r");
+		if (!file) {
+			return 0;
+		}
+		unsigned long size = 0;
+		unsigned long resident = 0;
+		const int result = std::fscanf(file, "%lu %lu", &size, &resident);
+		std::fclose(file);
+		if (result != 2) {
+			return 0;
+		}
+		return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+namespace py3lm {
+	// Resident set size of current process in bytes, 0 if not available
+	size_t GetResidentMemorySize();
+}
@@ -0,0 +1,68 @@
+#include "string_cache.hpp"
+#include <cstring>
+
+namespace py3lm {
+	namespace {
+		uint64_t HashString(std::string_view str) {
+			uint64_t hash = 0xcbf29ce484222325ULL;
+			for (const char ch : str) {
+				hash ^= static_cast<uint8_t>(ch);
+				hash *= 0x100000001b3ULL;
+			}
+			return hash;
+		}
+	}
+
+	void StringCache::Configure(size_t capacity, size_t maxLength) {
+		Clear();
+		_slots = {};
+		_mask = 0;
+		_maxLength = maxLength;
+		_hits = 0;
+		_misses = 0;
+		if (capacity == 0) {
+			return;
+		}
+		size_t size = 1;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		_slots.resize(size);
+		_mask = size - 1;
+	}
+
+	void StringCache::Clear() {
+		for (Slot& slot : _slots) {
+			Py_XDECREF(slot.object);
+			slot = {};
+		}
+	}
+
+	PyObject* StringCache::Get(std::string_view str) {
+		const uint64_t hash = HashString(str);
+		Slot& slot = _slots[hash & _mask];
+		if (slot.object && slot.hash == hash) {
+			// UTF-8 of ASCII str is its own storage, for other strings it is cached in the object after first use
+			Py_ssize_t size;
+			const char* const data = PyUnicode_AsUTF8AndSize(slot.object, &size);
+			if (data && static_cast<size_t>(size) == str.size() && std::memcmp(data, str.data(), str.size()) == 0) {
+				++_hits;
+				Py_INCREF(slot.object);
+				return slot.object;
+			}
+			if (!data) {
+				PyErr_Clear();
+			}
+		}
+		++_misses;
+		PyObject* const object = PyUnicode_FromStringAndSize(str.data(), static_cast<Py_ssize_t>(str.size()));
+		if (!object) {
+			return nullptr;
+		}
+		PyObject* const evicted = slot.object;
+		Py_INCREF(object);
+		slot = { hash, object };
+		Py_XDECREF(evicted);
+		return object;
+	}
+}
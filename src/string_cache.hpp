@@ -0,0 +1,42 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace py3lm {
+	// Bounded direct mapped cache of str objects for short strings repeatedly passed from native code.
+	// Equal strings share one object, so their hash is computed once and dict lookups match by identity.
+	class StringCache {
+	public:
+		// Capacity is rounded up to a power of two, 0 disables the cache
+		void Configure(size_t capacity, size_t maxLength);
+		void Clear();
+
+		bool Accepts(std::string_view str) const {
+			return str.size() <= _maxLength && !_slots.empty();
+		}
+
+		// Returns new reference
+		PyObject* Get(std::string_view str);
+
+		size_t Capacity() const { return _slots.size(); }
+		size_t MaxLength() const { return _maxLength; }
+		uint64_t Hits() const { return _hits; }
+		uint64_t Misses() const { return _misses; }
+
+	private:
+		struct Slot {
+			uint64_t hash{};
+			PyObject* object{};
+		};
+
+		std::vector<Slot> _slots;
+		size_t _mask{};
+		size_t _maxLength{};
+		uint64_t _hits{};
+		uint64_t _misses{};
+	};
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace py3lm {
+	// Hierarchical timer wheel (4 levels of 256 slots) with O(1) schedule and cancel.
+	// Time is measured in ticks, timers beyond the wheel range are re-cascaded until due.
+	class TimerWheel {
+	public:
+		using Handle = uint64_t;
+		static constexpr Handle InvalidHandle = 0;
+
+		TimerWheel() {
+			_nodes.resize(kHeads);
+			for (uint32_t i = 0; i < kHeads; ++i) {
+				_nodes[i].prev = i;
+				_nodes[i].next = i;
+			}
+		}
+
+		Handle Schedule(uint64_t delay, uint64_t interval, void* data) {
+			const uint32_t index = Allocate();
+			Node& node = _nodes[index];
+			node.expires = _current + (delay ? delay : 1);
+			node.interval = interval;
+			node.data = data;
+			node.active = true;
+			Insert(index);
+			++_count;
+			return MakeHandle(index, node.generation);
+		}
+
+		// Returns user data of cancelled timer or nullptr if handle is not active
+		void* Cancel(Handle handle) {
+			const uint32_t index = static_cast<uint32_t>(handle);
+			if (index < kHeads || index >= _nodes.size()) {
+				return nullptr;
+			}
+			Node& node = _nodes[index];
+			if (!node.active || node.generation != static_cast<uint32_t>(handle >> 32)) {
+				return nullptr;
+			}
+			void* const data = node.data;
+			Unlink(index);
+			Release(index);
+			return data;
+		}
+
+		// Calls func(data, repeating) for every expired timer, func may schedule and cancel timers.
+		// Ownership of data of one-shot timers is passed to func.
+		template<typename F>
+		void Advance(uint64_t ticks, F&& func) {
+			const uint64_t target = _current + ticks;
+			if (_count == 0) {
+				_current = target;
+				return;
+			}
+			while (_current < target && _count != 0) {
+				++_current;
+				for (uint32_t level = 1; level < kLevels; ++level) {
+					if ((_current & ((uint64_t{ 1 } << (kSlotBits * level)) - 1)) != 0) {
+						break;
+					}
+					Cascade(level);
+				}
+				Expire(std::forward<F>(func));
+			}
+			_current = target;
+		}
+
+		template<typename F>
+		void Clear(F&& func) {
+			for (uint32_t head = 0; head < kHeads; ++head) {
+				while (_nodes[head].next != head) {
+					const uint32_t index = _nodes[head].next;
+					void* const data = _nodes[index].data;
+					Unlink(index);
+					Release(index);
+					func(data);
+				}
+			}
+		}
+
+		// Cancels timers whose data matches pred, func(data) is called after all of them are removed
+		template<typename P, typename F>
+		void CancelIf(P&& pred, F&& func) {
+			std::vector<void*> cancelled;
+			for (uint32_t head = 0; head < kHeads; ++head) {
+				for (uint32_t index = _nodes[head].next; index != head;) {
+					const uint32_t next = _nodes[index].next;
+					if (pred(_nodes[index].data)) {
+						cancelled.push_back(_nodes[index].data);
+						Unlink(index);
+						Release(index);
+					}
+					index = next;
+				}
+			}
+			for (void* const data : cancelled) {
+				func(data);
+			}
+		}
+
+		size_t Count() const { return _count; }
+		uint64_t Now() const { return _current; }
+
+	private:
+		static constexpr uint32_t kLevels = 4;
+		static constexpr uint32_t kSlotBits = 8;
+		static constexpr uint32_t kSlots = 1 << kSlotBits;
+		static constexpr uint32_t kPending = kLevels * kSlots; // list of timers being expired
+		static constexpr uint32_t kHeads = kPending + 1; // first nodes are list sentinels
+
+		struct Node {
+			uint64_t expires{};
+			uint64_t interval{};
+			void* data{};
+			uint32_t prev{};
+			uint32_t next{};
+			uint32_t generation{ 1 };
+			bool active{};
+		};
+
+		static Handle MakeHandle(uint32_t index, uint32_t generation) {
+			return (static_cast<Handle>(generation) << 32) | index;
+		}
+
+		uint32_t Allocate() {
+			if (_free != 0) {
+				const uint32_t index = _free;
+				_free = _nodes[index].next;
+				return index;
+			}
+			_nodes.emplace_back();
+			return static_cast<uint32_t>(_nodes.size() - 1);
+		}
+
+		void Release(uint32_t index) {
+			Node& node = _nodes[index];
+			node.active = false;
+			node.data = nullptr;
+			++node.generation;
+			node.next = _free;
+			_free = index;
+			--_count;
+		}
+
+		void Link(uint32_t head, uint32_t index) {
+			Node& node = _nodes[index];
+			node.prev = _nodes[head].prev;
+			node.next = head;
+			_nodes[node.prev].next = index;
+			_nodes[head].prev = index;
+		}
+
+		void Unlink(uint32_t index) {
+			Node& node = _nodes[index];
+			_nodes[node.prev].next = node.next;
+			_nodes[node.next].prev = node.prev;
+			node.prev = node.next = index;
+		}
+
+		void Insert(uint32_t index) {
+			const uint64_t expires = _nodes[index].expires;
+			const uint64_t delta = expires > _current ? expires - _current : 0;
+			for (uint32_t level = 0; level < kLevels; ++level) {
+				if (delta < (uint64_t{ 1 } << (kSlotBits * (level + 1)))) {
+					const auto slot = static_cast<uint32_t>((std::max(expires, _current) >> (kSlotBits * level)) & (kSlots - 1));
+					Link(level * kSlots + slot, index);
+					return;
+				}
+			}
+			// Out of range, park in the last slot of top level and re-insert on cascade
+			constexpr uint32_t top = kLevels - 1;
+			const auto slot = static_cast<uint32_t>(((_current >> (kSlotBits * top)) - 1) & (kSlots - 1));
+			Link(top * kSlots + slot, index);
+		}
+
+		void Cascade(uint32_t level) {
+			const auto slot = static_cast<uint32_t>((_current >> (kSlotBits * level)) & (kSlots - 1));
+			const uint32_t head = level * kSlots + slot;
+			while (_nodes[head].next != head) {
+				const uint32_t index = _nodes[head].next;
+				Unlink(index);
+				Insert(index);
+			}
+		}
+
+		template<typename F>
+		void Expire(F&& func) {
+			const uint32_t head = static_cast<uint32_t>(_current & (kSlots - 1));
+			if (_nodes[head].next == head) {
+				return;
+			}
+			// Move slot to pending list, so timers scheduled by callbacks are not processed in this tick
+			while (_nodes[head].next != head) {
+				const uint32_t index = _nodes[head].next;
+				Unlink(index);
+				Link(kPending, index);
+			}
+			while (_nodes[kPending].next != kPending) {
+				const uint32_t index = _nodes[kPending].next;
+				Unlink(index);
+				Node& node = _nodes[index];
+				if (node.expires > _current) {
+					Insert(index);
+					continue;
+				}
+				void* const data = node.data;
+				if (node.interval) {
+					node.expires = _current + node.interval;
+					Insert(index);
+					func(data, true);
+				} else {
+					Release(index);
+					func(data, false);
+				}
+			}
+		}
+
+		std::vector<Node> _nodes;
+		uint64_t _current{};
+		size_t _count{};
+		uint32_t _free{};
+	};
+}
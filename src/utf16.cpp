@@ -0,0 +1,96 @@
+#include "utf16.hpp"
+#include <algorithm>
+
+// Build targets baseline x86-64, so kernels use SSE2 only
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PY3LM_UTF16_SSE2 1
+#endif
+
+namespace py3lm {
+	namespace {
+		bool IsSurrogate(uint32_t unit) {
+			return (unit & 0xF800) == 0xD800;
+		}
+	}
+
+	Utf16Scan ScanUtf16(const char16_t* data, size_t size) {
+		size_t i = 0;
+		uint16_t maxUnit = 0;
+		bool surrogates = false;
+#if PY3LM_UTF16_SSE2
+		// SSE2 has signed 16-bit max only, bias units to compare them as signed
+		const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+		__m128i max = bias;
+		__m128i found = _mm_setzero_si128();
+		const __m128i mask = _mm_set1_epi16(static_cast<short>(0xF800));
+		const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+		for (; i + 8 <= size; i += 8) {
+			const __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			max = _mm_max_epi16(max, _mm_xor_si128(units, bias));
+			found = _mm_or_si128(found, _mm_cmpeq_epi16(_mm_and_si128(units, mask), surrogate));
+		}
+		alignas(16) uint16_t lanes[8];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(max, bias));
+		maxUnit = *std::max_element(lanes, lanes + 8);
+		surrogates = _mm_movemask_epi8(found) != 0;
+#endif
+		for (; i < size; ++i) {
+			const auto unit = static_cast<uint16_t>(data[i]);
+			maxUnit = std::max(maxUnit, unit);
+			surrogates |= IsSurrogate(unit);
+		}
+		return { static_cast<char16_t>(maxUnit), surrogates };
+	}
+
+	void NarrowUtf16(const char16_t* src, size_t size, uint8_t* dst) {
+		size_t i = 0;
+#if PY3LM_UTF16_SSE2
+		for (; i + 16 <= size; i += 16) {
+			const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+		}
+#endif
+		for (; i < size; ++i) {
+			dst[i] = static_cast<uint8_t>(src[i]);
+		}
+	}
+
+	void WidenLatin1(const uint8_t* src, size_t size, char16_t* dst) {
+		size_t i = 0;
+#if PY3LM_UTF16_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= size; i += 16) {
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(bytes, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(bytes, zero));
+		}
+#endif
+		for (; i < size; ++i) {
+			dst[i] = static_cast<char16_t>(src[i]);
+		}
+	}
+
+	size_t Utf16Length(const uint32_t* src, size_t size) {
+		size_t length = size;
+		for (size_t i = 0; i < size; ++i) {
+			length += src[i] > 0xFFFF;
+		}
+		return length;
+	}
+
+	size_t EncodeUtf16(const uint32_t* src, size_t size, char16_t* dst) {
+		char16_t* const begin = dst;
+		for (size_t i = 0; i < size; ++i) {
+			const uint32_t ch = src[i];
+			if (ch > 0xFFFF) {
+				*dst++ = static_cast<char16_t>(0xD800 + ((ch - 0x10000) >> 10));
+				*dst++ = static_cast<char16_t>(0xDC00 + ((ch - 0x10000) & 0x3FF));
+			} else {
+				*dst++ = static_cast<char16_t>(ch);
+			}
+		}
+		return static_cast<size_t>(dst - begin);
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace py3lm {
+	// Transcoding between UTF-16 buffers and the compact representations of python str
+	// (Latin-1, UCS-2 and UCS-4), vectorized with SSE2 when available.
+
+	struct Utf16Scan {
+		char16_t maxUnit;
+		bool surrogates;
+	};
+
+	Utf16Scan ScanUtf16(const char16_t* data, size_t size);
+
+	// Every unit must be below 0x100
+	void NarrowUtf16(const char16_t* src, size_t size, uint8_t* dst);
+
+	void WidenLatin1(const uint8_t* src, size_t size, char16_t* dst);
+
+	// Number of UTF-16 units needed for code points
+	size_t Utf16Length(const uint32_t* src, size_t size);
+
+	// Returns number of units written, dst must hold Utf16Length(src, size) units
+	size_t EncodeUtf16(const uint32_t* src, size_t size, char16_t* dst);
+}
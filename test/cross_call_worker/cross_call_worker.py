@@ -1,6 +1,13 @@
+import asyncio
+import contextvars
 import sys
+from array import array
+from enum import IntEnum
 from plugify.plugin import Plugin, Vector2, Vector3, Vector4, Matrix4x4
 from plugify.pps import (cross_call_master as master)
+from plugify._core import NativeArray
+from plugify import arrays, handles, refs, strings, timers, _aio
+from plugify.aio import NativeEvent
 
 
 def bool_str(b):
@@ -69,8 +76,29 @@ def pod_to_string(pod):
 # <<< Test part >>>
 
 class CrossCallWorker(Plugin):
+	update_rate = 10
+	updating = False
+	update_checked = False
+
 	def plugin_start(self):
 		print('CrossCallWorker::plugin_start')
+		check_plugin_reexports()
+		check_lazy_enums()
+		self.timer_checks = TimerChecks(self)
+
+	async def plugin_update(self, dt):
+		# Async plugin_update runs as a task, the next call waits until it finishes
+		if self.updating:
+			raise AssertionError('plugin_update entered while previous call is pending')
+		self.updating = True
+		try:
+			if not self.update_checked:
+				await check_async_update(self)
+				await self.timer_checks.wait()
+				self.update_checked = True
+				print('CrossCallWorker::plugin_update checks passed')
+		finally:
+			self.updating = False
 
 
 def no_param_return_void():
@@ -2437,7 +2465,553 @@ reverse_test = {
 }
 
 
+# <<< Marshalling variants >>>
+# Each variant passes the same values in another accepted form and must produce the same result as its reverse test
+
+
+class IndexInt:
+    def __init__(self, value):
+        self.value = value
+
+    def __index__(self):
+        return self.value
+
+
+def variant_param_all_primitives_index():
+    result = master.ParamAllPrimitivesCallback(True, '%', '☢', IndexInt(-1), IndexInt(-1000), IndexInt(-1000000),
+                                                              IndexInt(-1000000000000), IndexInt(200), IndexInt(50000),
+                                                              IndexInt(3000000000), IndexInt(9999999999), 0xfedcbaabcdef,
+                                                              0.001, 987654.456789)
+    return f'{result}'
+
+
+def variant_call_func_int32_vector_index():
+    result = master.CallFuncInt32VectorCallback(lambda: [IndexInt(1000), IndexInt(2000)])
+    return vector_to_string(result)
+
+
+def variant_call_func_uint64_vector_index():
+    result = master.CallFuncUInt64VectorCallback(lambda: [IndexInt(20000), IndexInt(30000)])
+    return vector_to_string(result)
+
+
+def call_param_variant_ref(p1, p2):
+    _, p1, p2 = master.ParamVariantRefCallback(p1, p2)
+    return f'{vector_to_string(p1)}|{{{bool_str(p2[0])}, {float_str(p2[1])}, {p2[2]}}}'
+
+
+variant_any_values = ['X', '☢', -1, -1000, -1000000, -1000000000000, 200, 50000, 3000000000, 9999999999,
+                      0xfedcbaabcdef, 0.001, 987654.456789]
+
+
+def variant_param_variant_ref_int_list():
+    return call_param_variant_ref([-1, -1000, 3000000000], variant_any_values)
+
+
+def variant_param_variant_ref_vector_list():
+    return call_param_variant_ref([Vector3(1.0, 2.0, 3.0), Vector3(4.0, 5.0, 6.0)], variant_any_values)
+
+
+class Text(str):
+    pass
+
+
+class Real(float):
+    pass
+
+
+class Level(IntEnum):
+    One = 1
+    Big = 3000000000
+
+
+def variant_param_variant_ref_subclasses():
+    p2 = [Text('X'), Text('☢'), -1, -1000, -1000000, -1000000000000, 200, 50000, Level.Big, 9999999999,
+          0xfedcbaabcdef, Real(0.001), 987654.456789]
+    return call_param_variant_ref(Text('my custom string with enough chars'), p2)
+
+
+def variant_param_variant_ref_enum_list():
+    return call_param_variant_ref([Level.One, 2, Level.Big], variant_any_values)
+
+
+def variant_call_func_any_vector_subclasses():
+    result = master.CallFuncAnyVectorCallback(lambda: [Text('Hello'), Real(3.14), 6.28, Level.One, 0xdeadbeaf])
+    return vector_to_string(result, plain_str)
+
+
+def param_ref_vectors_str(result):
+    _, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15 = result
+    return f'{vector_to_string(p1, bool_str)}|{vector_to_string(p2, char8_str)}|{vector_to_string(p3, char16_str)}|' \
+           f'{vector_to_string(p4)}|{vector_to_string(p5)}|{vector_to_string(p6)}|{vector_to_string(p7)}|' \
+           f'{vector_to_string(p8)}|{vector_to_string(p9)}|{vector_to_string(p10)}|{vector_to_string(p11)}|' \
+           f'{vector_to_string(p12, ptr_str)}|{vector_to_string(p13, float_str)}|{vector_to_string(p14)}|' \
+           f'{vector_to_string(p15, quote_str)}'
+
+
+def variant_param_ref_vectors_char_str():
+    return param_ref_vectors_str(master.ParamRefVectorsCallback(
+        [True], 'A', 'A', [-1], [-1], [-1], [-1], [0], [0], [0], [0], [0], [1.0], [1.0], ['Hi']
+    ))
+
+
+def variant_param_ref_vectors_char_bytes():
+    return param_ref_vectors_str(master.ParamRefVectorsCallback(
+        [True], b'A', 'A', [-1], [-1], [-1], [-1], [0], [0], [0], [0], [0], [1.0], [1.0], ['Hi']
+    ))
+
+
+def variant_param_ref_vectors_char_arrays():
+    return param_ref_vectors_str(strings.char_arrays(master.ParamRefVectorsCallback)(
+        [True], ['A'], ['A'], [-1], [-1], [-1], [-1], [0], [0], [0], [0], [0], [1.0], [1.0], ['Hi']
+    ))
+
+
+def variant_no_param_return_array_char8_str():
+    result = strings.char_arrays(master.NoParamReturnArrayChar8Callback)()
+    if not isinstance(result, str):
+        raise TypeError(f'Expected str, but {type(result).__name__} returned')
+    return vector_to_string(result, char8_str)
+
+
+def variant_no_param_return_array_char16_str():
+    result = strings.char_arrays(master.NoParamReturnArrayChar16Callback)()
+    if not isinstance(result, str):
+        raise TypeError(f'Expected str, but {type(result).__name__} returned')
+    return vector_to_string(result, char16_str)
+
+
+def variant_call_func_char8_vector_str():
+    result = master.CallFuncChar8VectorCallback(lambda: 'AB')
+    return vector_to_string(result, char8_str)
+
+
+def variant_call_func_char8_vector_bytes():
+    result = master.CallFuncChar8VectorCallback(lambda: b'AB')
+    return vector_to_string(result, char8_str)
+
+
+def variant_call_func_char16_vector_str():
+    result = master.CallFuncChar16VectorCallback(lambda: 'AB')
+    return vector_to_string(result, char16_str)
+
+
+def variant_no_param_return_string_cached():
+    strings.enable_cache(max_length=4096)
+    try:
+        first = master.NoParamReturnStringCallback()
+        second = master.NoParamReturnStringCallback()
+    finally:
+        strings.disable_cache()
+    if second is not first:
+        raise AssertionError('Cached str is not reused')
+    return second
+
+
+def variant_no_param_return_array_string_cached():
+    strings.enable_cache(max_length=4096)
+    try:
+        result = master.NoParamReturnArrayStringCallback()
+    finally:
+        strings.disable_cache()
+    return vector_to_string(result, quote_str)
+
+
+def variant_call_func_string_bytes():
+    result = master.CallFuncStringCallback(lambda: b'Test string')
+    return result
+
+
+def variant_param_ref7_bytes_rejected():
+    try:
+        master.ParamRef7Callback(0, 0.0, 0.0, Vector4(), [], '', b'')
+    except TypeError:
+        return reverse_param_ref7()
+    raise AssertionError('bytes accepted for string reference parameter')
+
+
+def variant_call_func_string_vector_tuple():
+    result = master.CallFuncStringVectorCallback(lambda: ('Hello', 'World'))
+    return vector_to_string(result, quote_str)
+
+
+def variant_call_func_string_vector_bytes():
+    result = master.CallFuncStringVectorCallback(lambda: [b'Hello', 'World'])
+    return vector_to_string(result, quote_str)
+
+
+def variant_param_ref_vectors_string_tuple():
+    return param_ref_vectors_str(master.ParamRefVectorsCallback(
+        [True], ['A'], ['A'], [-1], [-1], [-1], [-1], [0], [0], [0], [0], [0], [1.0], [1.0], ('Hi',)
+    ))
+
+
+def check_native_array(result):
+    if not isinstance(result, NativeArray):
+        raise TypeError(f'Expected NativeArray, but {type(result).__name__} returned')
+    items = result.to_list()
+    if result != items or result != tuple(items):
+        raise AssertionError('NativeArray is not equal to its items')
+    return result
+
+
+def variant_no_param_return_array_string_lazy():
+    result = check_native_array(arrays.lazy(master.NoParamReturnArrayStringCallback, min_size=1)())
+    return vector_to_string(result, quote_str)
+
+
+def variant_no_param_return_array_string_below_lazy():
+    result = arrays.lazy(master.NoParamReturnArrayStringCallback, min_size=1 << 20)()
+    if not isinstance(result, list):
+        raise TypeError(f'Expected list, but {type(result).__name__} returned')
+    return vector_to_string(result, quote_str)
+
+
+def variant_no_param_return_array_any_lazy():
+    result = check_native_array(arrays.lazy(master.NoParamReturnArrayAnyCallback, min_size=1)())
+    return vector_to_string(result, plain_str)
+
+
+def variant_no_param_return_array_int32_native():
+    result = check_native_array(arrays.native_returns(master.NoParamReturnArrayInt32Callback)())
+    if memoryview(result).tolist() != result.to_list():
+        raise AssertionError('NativeArray buffer differs from its items')
+    return vector_to_string(result)
+
+
+def variant_no_param_return_array_float_native():
+    result = check_native_array(arrays.native_returns(master.NoParamReturnArrayFloatCallback)())
+    return vector_to_string(result, float_str)
+
+
+def variant_param_ref_vectors_native_arrays():
+    native = arrays.native_returns
+    int32s = native(master.NoParamReturnArrayInt32Callback)()
+    return param_ref_vectors_str(master.ParamRefVectorsCallback(
+        [True], ['A'], ['A'],
+        native(master.NoParamReturnArrayInt8Callback)(),
+        native(master.NoParamReturnArrayInt16Callback)(),
+        int32s,
+        int32s,  # elements are converted to int64
+        native(master.NoParamReturnArrayUInt8Callback)(),
+        native(master.NoParamReturnArrayUInt16Callback)(),
+        native(master.NoParamReturnArrayUInt32Callback)(),
+        native(master.NoParamReturnArrayUInt64Callback)(),
+        native(master.NoParamReturnArrayPointerCallback)(),
+        native(master.NoParamReturnArrayFloatCallback)(),
+        native(master.NoParamReturnArrayDoubleCallback)(),
+        ['Hi']
+    ))
+
+
+def variant_call_func_ptr_none():
+    result = master.CallFuncPtrCallback(lambda: None)
+    return ptr_str(result)
+
+
+def variant_call_func_ptr_handle():
+    context = Vector2(1.0, 2.0)
+    count = handles.count()
+    handle = handles.ref(context)
+    try:
+        result = master.CallFuncPtrCallback(lambda: handle)
+        if handles.get(result) is not context:
+            raise AssertionError('Handle passed through native code does not resolve to its object')
+    finally:
+        handles.release(handle)
+    if handles.count() != count:
+        raise AssertionError('Released handle is still alive')
+    return reverse_call_func_ptr()
+
+
+class RefViewsHolder:
+    @staticmethod
+    @refs.views
+    def mock_func17(ref_val):
+        ref_val.value += 10
+
+    @staticmethod
+    @refs.views
+    def mock_func18(i8, i16):
+        i8.value = 5
+        i16.value = 10
+        return Vector2(5.0, 10.0)
+
+    @staticmethod
+    @refs.views
+    def mock_func19(u32, v3, u_vec):
+        u32.value = 42
+        v3.value = Vector3(1.0, 2.0, 3.0)
+        u_vec.value = [1, 2, 0]
+        u_vec[2] = 3
+
+    @staticmethod
+    @refs.views
+    def mock_func20(c, v4, u_vec, ch):
+        c.value = 't'
+        v4.value = Vector4(1.0, 2.0, 3.0, 4.0)
+        u_vec.value = [100, 200]
+        ch.value = 'F'
+        return 0
+
+    @staticmethod
+    @refs.views
+    def mock_func21(m, i_vec, v2, flag, d):
+        flag.value = True
+        d.value = 3.14
+        v2.value = Vector2(1.0, 2.0)
+        m.value = Matrix4x4([
+            [1.3, 0.6, 0.8, 0.5],
+            [0.7, 1.1, 0.2, 0.4],
+            [0.9, 0.3, 1.2, 0.7],
+            [0.2, 0.8, 0.5, 1.0]
+        ])
+        i_vec.value = [1, 2, 3]
+        return 0.0
+
+    @staticmethod
+    @refs.views
+    def mock_func22(p, u32, d_vec, i16, s, v4):
+        p.value = 0
+        u32.value = 99
+        i16.value = 123
+        s.value = 'Hello'
+        v4.value = Vector4(1.0, 2.0, 3.0, 4.0)
+        d_vec.value = [1.1, 2.2, 3.3]
+        return 0
+
+
+def variant_call_func17_views():
+    return master.CallFunc17Callback(RefViewsHolder.mock_func17)
+
+
+def variant_call_func18_views():
+    return master.CallFunc18Callback(RefViewsHolder.mock_func18)
+
+
+def variant_call_func19_views():
+    return master.CallFunc19Callback(RefViewsHolder.mock_func19)
+
+
+def variant_call_func20_views():
+    return master.CallFunc20Callback(RefViewsHolder.mock_func20)
+
+
+def variant_call_func21_views():
+    return master.CallFunc21Callback(RefViewsHolder.mock_func21)
+
+
+def variant_call_func22_views():
+    return master.CallFunc22Callback(RefViewsHolder.mock_func22)
+
+
+def variant_param_ref10_in_place():
+    a, b, c, d, e, f, g, h, k, l = [0], [0.0], [0.0], Vector4(), [], [''], [''], [''], [0], [0]
+    result = refs.in_place(master.ParamRef10Callback)(a, b, c, d, e, f, g, h, k, l)
+    if result is not None:
+        raise AssertionError(f'Expected no return value, but {result!r} returned')
+    return f'{a[0]}|{float_str(b[0])}|{c[0]}|{pod_to_string(d)}|{vector_to_string(e)}|{ord_zero(f[0])}|{g[0]}|' \
+           f'{ord_zero(h[0])}|{k[0]}|{ptr_str(l[0])}'
+
+
+def variant_param_ref_vectors_in_place():
+    args = ([True], ['A'], ['A'], [-1], [-1], [-1], [-1], [0], [0], [0], [0], [0], [1.0], [1.0], ['Hi'])
+    refs.in_place(master.ParamRefVectorsCallback)(*args)
+    return param_ref_vectors_str((None, *args))
+
+
+def variant_param_ref_vectors_in_place_buffers():
+    int32s = arrays.native_returns(master.NoParamReturnArrayInt32Callback)()
+    args = ([True], ['A'], ['A'], array('b', [-1]), array('h', [-1]), int32s, array('q', [-1]), bytearray(1),
+            array('H', [0]), array('I', [0]), array('Q', [0]), [0], array('f', [1.0]), array('d', [1.0]), ['Hi'])
+    refs.in_place(master.ParamRefVectorsCallback)(*args)
+    return param_ref_vectors_str((None, *args))
+
+
+def variant_param_enum_ref_in_place():
+    e = master.Example
+    p1, p2 = [e.First], [e.First, e.First, e.Second]
+    result = refs.in_place(master.ParamEnumRefCallback)(p1, p2)
+    return f'{result}|{enum_str(p1[0])}|{vector_to_string(p2, enum_str)}'
+
+
+def variant_param_ref_vectors_tuples():
+    return param_ref_vectors_str(master.ParamRefVectorsCallback(
+        (True,), ('A',), ('A',), (-1,), (-1,), (-1,), (-1,), (0,), (0,), (0,), (0,), (0,), (1.0,), (1.0,), ('Hi',)
+    ))
+
+
+def variant_call_func_int64_vector_tuple():
+    result = master.CallFuncInt64VectorCallback(lambda: (10000, 20000))
+    return vector_to_string(result)
+
+
+def variant_call_func_int64_vector_index_first():
+    result = master.CallFuncInt64VectorCallback(lambda: (IndexInt(10000), 20000))
+    return vector_to_string(result)
+
+
+def variant_call_func_int64_vector_index_last():
+    result = master.CallFuncInt64VectorCallback(lambda: [10000, IndexInt(20000)])
+    return vector_to_string(result)
+
+
+def variant_call_func_float_vector_tuple():
+    result = master.CallFuncFloatVectorCallback(lambda: (1.1, 2.2))
+    return vector_to_string(result, float_str)
+
+
+def variant_call_func_double_vector_tuple():
+    result = master.CallFuncDoubleVectorCallback(lambda: (3.3, 4.4))
+    return vector_to_string(result)
+
+
+def variant_call_func_vec3_vector_tuple():
+    result = master.CallFuncVec3VectorCallback(lambda: tuple(CallbackHolder.mock_vec3_array()))
+    return vector_to_string(result, pod_to_string)
+
+
+marshalling_variants = {
+    'ParamAllPrimitives': [variant_param_all_primitives_index],
+    'CallFuncInt32Vector': [variant_call_func_int32_vector_index],
+    'CallFuncUInt64Vector': [variant_call_func_uint64_vector_index],
+    'ParamVariantRef': [variant_param_variant_ref_int_list, variant_param_variant_ref_vector_list,
+                        variant_param_variant_ref_subclasses, variant_param_variant_ref_enum_list],
+    'CallFuncAnyVector': [variant_call_func_any_vector_subclasses],
+    'ParamRefVectors': [variant_param_ref_vectors_char_str, variant_param_ref_vectors_char_bytes,
+                        variant_param_ref_vectors_char_arrays, variant_param_ref_vectors_string_tuple,
+                        variant_param_ref_vectors_native_arrays, variant_param_ref_vectors_in_place,
+                        variant_param_ref_vectors_in_place_buffers, variant_param_ref_vectors_tuples],
+    'NoParamReturnArrayChar8': [variant_no_param_return_array_char8_str],
+    'NoParamReturnArrayChar16': [variant_no_param_return_array_char16_str],
+    'CallFuncChar8Vector': [variant_call_func_char8_vector_str, variant_call_func_char8_vector_bytes],
+    'CallFuncChar16Vector': [variant_call_func_char16_vector_str],
+    'NoParamReturnString': [variant_no_param_return_string_cached],
+    'NoParamReturnArrayString': [variant_no_param_return_array_string_cached, variant_no_param_return_array_string_lazy,
+                                 variant_no_param_return_array_string_below_lazy],
+    'NoParamReturnArrayAny': [variant_no_param_return_array_any_lazy],
+    'NoParamReturnArrayInt32': [variant_no_param_return_array_int32_native],
+    'NoParamReturnArrayFloat': [variant_no_param_return_array_float_native],
+    'CallFuncPtr': [variant_call_func_ptr_none, variant_call_func_ptr_handle],
+    'CallFunc17': [variant_call_func17_views],
+    'CallFunc18': [variant_call_func18_views],
+    'CallFunc19': [variant_call_func19_views],
+    'CallFunc20': [variant_call_func20_views],
+    'CallFunc21': [variant_call_func21_views],
+    'CallFunc22': [variant_call_func22_views],
+    'ParamRef10': [variant_param_ref10_in_place],
+    'ParamEnumRef': [variant_param_enum_ref_in_place],
+    'CallFuncInt64Vector': [variant_call_func_int64_vector_tuple, variant_call_func_int64_vector_index_first,
+                            variant_call_func_int64_vector_index_last],
+    'CallFuncFloatVector': [variant_call_func_float_vector_tuple],
+    'CallFuncDoubleVector': [variant_call_func_double_vector_tuple],
+    'CallFuncVec3Vector': [variant_call_func_vec3_vector_tuple],
+    'CallFuncString': [variant_call_func_string_bytes],
+    'ParamRef7': [variant_param_ref7_bytes_rejected],
+    'CallFuncStringVector': [variant_call_func_string_vector_tuple, variant_call_func_string_vector_bytes],
+}
+
+
 def reverse_call(test):
     result = reverse_test[test]()
+    for variant in marshalling_variants.get(test, ()):
+        variant_result = variant()
+        if variant_result != result:
+            raise AssertionError(f'{test} {variant.__name__}: {variant_result!r} != {result!r}')
     if result is not None:
         master.ReverseReturn(result)
+
+
+# <<< Runtime checks of the language module >>>
+
+async def check_async_update(plugin):
+    # Code of the plugin runs in its context, tasks copy it and are cancelled when the plugin ends
+    if _aio.current_plugin.get(None) != plugin.id:
+        raise AssertionError('plugin_update task does not run in plugin context')
+    child = asyncio.get_running_loop().create_task(asyncio.sleep(0.01, result='slept'))
+    if child.get_context().get(_aio.current_plugin) != plugin.id:
+        raise AssertionError('task created by plugin_update does not belong to the plugin')
+    event = NativeEvent()
+    waiter = event.wait()
+    event(1, 2)
+    if await waiter != (1, 2):
+        raise AssertionError('NativeEvent did not pass callback arguments')
+    if await child != 'slept':
+        raise AssertionError('child task of plugin_update did not finish')
+
+
+def check_plugin_reexports():
+    # plugify.plugin is a shim over the built-in plugify._core module, types must be the same objects
+    import plugify.plugin
+    import plugify._core
+    for name in plugify.plugin.__all__:
+        if getattr(plugify.plugin, name) is not getattr(plugify._core, name):
+            raise AssertionError(f'plugify.plugin.{name} is not plugify._core.{name}')
+    if not issubclass(CrossCallWorker, plugify._core.Plugin):
+        raise AssertionError('worker plugin class is not subclass of plugify._core.Plugin')
+
+
+def check_lazy_enums():
+    # Enum classes are created by module __getattr__ on first access and then stored in the module
+    classes = []
+    for module in (master, sys.modules[__name__]):
+        if 'Example' not in vars(module) and '__getattr__' not in vars(module):
+            raise AssertionError(f'{module.__name__} has neither Example nor lazy __getattr__')
+        example = module.Example
+        if not issubclass(example, IntEnum) or vars(module).get('Example') is not example:
+            raise AssertionError(f'{module.__name__}.Example is not stored IntEnum class')
+        if example(int(example.First)) is not example.First:
+            raise AssertionError(f'{module.__name__}.Example member is not found by value')
+        try:
+            getattr(module, 'MissingEnum')
+        except AttributeError:
+            pass
+        else:
+            raise AssertionError(f'{module.__name__}.MissingEnum resolved')
+        classes.append({member.name: int(member) for member in example})
+    if classes[0] != classes[1]:
+        raise AssertionError(f'Example members differ: {classes[0]!r} != {classes[1]!r}')
+
+
+class TimerChecks:
+    """
+    Timers scheduled by plugin code belong to the plugin and run in its context, a repeating timer can cancel itself.
+    """
+
+    def __init__(self, plugin):
+        self.plugin = plugin
+        self.calls = []
+        cancelled = timers.call_later(0.0, self.fail)
+        if timers.cancel(cancelled) is not True or timers.cancel(cancelled) is not False:
+            raise AssertionError('timers.cancel did not report whether timer was pending')
+        try:
+            contextvars.Context().run(timers.call_later, 0.0, self.fail)
+        except RuntimeError:
+            pass
+        else:
+            raise AssertionError('timer without owning plugin was scheduled')
+        timers.call_later(0.01, lambda: self.record('once'))
+        self.repeating = timers.call_repeating(0.01, self.repeat)
+
+    def fail(self):
+        raise AssertionError('cancelled timer was called')
+
+    def record(self, name):
+        if _aio.current_plugin.get(None) != self.plugin.id:
+            raise AssertionError(f'timer {name} does not run in plugin context')
+        self.calls.append(name)
+
+    def repeat(self):
+        self.record('repeat')
+        if self.calls.count('repeat') == 3:
+            timers.cancel(self.repeating)
+
+    async def wait(self):
+        loop = asyncio.get_running_loop()
+        deadline = loop.time() + 5.0
+        while len(self.calls) < 4 and loop.time() < deadline:
+            await asyncio.sleep(0.01)
+        # Cancelled repeating timer must not fire again
+        await asyncio.sleep(0.05)
+        if sorted(self.calls) != ['once', 'repeat', 'repeat', 'repeat']:
+            raise AssertionError(f'unexpected timer calls: {self.calls!r}')